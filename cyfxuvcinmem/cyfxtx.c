@@ -35,8 +35,10 @@
 
 #include <cyu3os.h>
 #include <cyu3utils.h>
+#include <cyu3system.h>
 #include <cyu3error.h>
 #include <cyfxversion.h>
+#include "cyfxtx.h"
 
 /* Memory error detection is supported in SDK 1.3.3 and later. */
 #if ((CYFX_VERSION_MINOR > 3) || ((CYFX_VERSION_MINOR == 3) && (CYFX_VERSION_PATCH >= 3)))
@@ -58,8 +60,8 @@
    2-stage boot area  Base: 0x40038000 Size: 32  KB
 
    Note: The 2-stage boot area is optional (only required if the application makes use of a persistent
-   in-memory boot-loader). If this is not being used, the 32 KB reserved for this segment can be merged
-   into the buffer area by changing CY_U3P_SYS_MEM_TOP to 0x40040000.
+   in-memory boot-loader). If this is not being used, the 32 KB reserved for this segment can be handed
+   to the buffer allocator as an additional region by defining CYFXTX_RECLAIM_BOOT_AREA.
  */
 
 /*
@@ -71,10 +73,11 @@
 #define CY_U3P_MEM_HEAP_SIZE         (0x7000)
 
 /*
-   The last 32 KB of RAM is reserved for 2-stage boot operation. This value can be
-   changed to 0x40040000 if 2-stage boot is not used by the application.
+   The last 32 KB of RAM is reserved for 2-stage boot operation. This area is given to
+   the buffer allocator if CYFXTX_RECLAIM_BOOT_AREA is defined.
  */
 #define CY_U3P_SYS_MEM_TOP           (0x40038000)
+#define CY_U3P_BOOT_AREA_SIZE        (0x8000)
 
 #else /* 512 KB RAM is available. */
 
@@ -89,8 +92,8 @@
    2-stage boot area  Base: 0x40078000 Size: 32  KB
 
    Note: The 2-stage boot area is optional (only required if the application makes use of a persistent
-   in-memory boot-loader). If this is not being used, the 32 KB reserved for this segment can be merged
-   into the buffer area by changing CY_U3P_SYS_MEM_TOP to 0x40080000.
+   in-memory boot-loader). If this is not being used, the 32 KB reserved for this segment can be handed
+   to the buffer allocator as an additional region by defining CYFXTX_RECLAIM_BOOT_AREA.
  */
 
 /*
@@ -102,10 +105,11 @@
 #define CY_U3P_MEM_HEAP_SIZE         (0x8000)
 
 /*
-   The last 32 KB of RAM is reserved for 2-stage boot operation. This value can be
-   changed to 0x40080000 if 2-stage boot is not used by the application.
+   The last 32 KB of RAM is reserved for 2-stage boot operation. This area is given to
+   the buffer allocator if CYFXTX_RECLAIM_BOOT_AREA is defined.
  */
 #define CY_U3P_SYS_MEM_TOP           (0x40078000)
+#define CY_U3P_BOOT_AREA_SIZE        (0x8000)
 
 #endif
 
@@ -118,12 +122,27 @@
 #define CY_U3P_BUFFER_HEAP_BASE         (CY_U3P_MEM_HEAP_BASE + CY_U3P_MEM_HEAP_SIZE)
 #define CY_U3P_BUFFER_HEAP_SIZE         ((CY_U3P_SYS_MEM_TOP) - (CY_U3P_BUFFER_HEAP_BASE))
 
+/*
+   The buffer allocator can manage more than one (possibly discontiguous) region of
+   memory. Each region has its own status bitmap, and an allocated buffer never spans
+   two regions. The first region is always the buffer area defined above.
+ */
+#define CY_U3P_BUFFER_MAX_REGIONS       (2)
+
 #define CY_U3P_BUFFER_ALLOC_TIMEOUT     (10)
 #define CY_U3P_MEM_ALLOC_TIMEOUT        (10)
 
 #define CY_U3P_MEM_START_SIG            (0x4658334D)
 #define CY_U3P_MEM_END_SIG              (0x454E444D)
 
+/*
+   Layout of a block in the ThreadX byte pool: the block starts with a pointer to the next block,
+   followed by a pointer sized marker that holds TX_BYTE_BLOCK_FREE if the block is free. The blocks
+   form a circular list that starts and ends at the beginning of the pool.
+ */
+#define CY_U3P_BYTE_BLOCK_HDR_SIZE      (2 * sizeof (uint8_t *))
+#define CY_U3P_BYTE_BLOCK_FREE          (0xFFFFEEEEUL)
+
 /* Round a given value up to a multiple of n (assuming n is a power of 2). */
 #define ROUND_UP(s, n)                  (((s) + (n) - 1) & (~(n - 1)))
 /* Convert size from BYTE to DWORD. */
@@ -131,9 +150,47 @@
 /* Cache line size for FX3. */
 #define FX3_CACHE_LINE_SZ               (32)
 
+/* Space reserved for the MemBlockInfo header of a checked buffer heap block. A whole cache line
+   is used so that the buffer returned to the caller stays cache line aligned, and the header is
+   never in a cache line that is cleaned or invalidated for a DMA transfer into the buffer. */
+#define CY_U3P_BUF_HDR_SIZE             (FX3_CACHE_LINE_SZ)
+
+/* State of one memory region managed by the buffer allocator. */
+typedef struct CyFxBufRegion_t
+{
+    uint32_t  startAddr;                /* Start address of the region. */
+    uint32_t  regionSize;               /* Size of the region in bytes. */
+    uint32_t *usedStatus;               /* Bitmap with one bit per cache line in the region. */
+    uint32_t  statusSize;               /* Size of the bitmap in DWORDs. */
+    uint32_t  searchPos;                /* DWORD from which the next search starts. */
+} CyFxBufRegion_t;
+
+/* Buffer manager covering all regions in the buffer heap. */
+typedef struct CyFxBufMgr_t
+{
+    CyU3PMutex      lock;                                       /* Lock for all regions. */
+    uint32_t        numRegions;                                 /* Number of initialized regions. */
+    uint32_t        usedLines;                                  /* Number of cache lines allocated. */
+    CyFxBufRegion_t region[CY_U3P_BUFFER_MAX_REGIONS];          /* Per region state. */
+} CyFxBufMgr_t;
+
+/* Memory regions handed to the buffer manager, in the order in which they are searched. */
+static const uint32_t glBufRegionList[][2] =
+{
+    { CY_U3P_BUFFER_HEAP_BASE, CY_U3P_BUFFER_HEAP_SIZE },
+#ifdef CYFXTX_RECLAIM_BOOT_AREA
+    { CY_U3P_SYS_MEM_TOP,      CY_U3P_BOOT_AREA_SIZE }
+#endif
+};
+
 static CyBool_t         glMemPoolInit   = CyFalse;              /* Whether the memory allocator has been initialized. */
 static CyU3PBytePool    glMemBytePool;                          /* ThreadX Byte pool used in the CyU3PMem* functions. */
-static CyU3PDmaBufMgr_t glBufferManager = {{0}, 0, 0, 0, 0, 0}; /* Buffer manager used in the buffer alloc functions. */
+static CyFxBufMgr_t     glBufferManager;                        /* Buffer manager used in the buffer alloc functions. */
+
+static uint32_t         glMemPeakUsed     = 0;                  /* Peak driver heap usage in bytes. */
+static uint32_t         glMemAllocFailCnt = 0;                  /* Number of failed CyU3PMemAlloc calls. */
+static uint32_t         glBufPeakLines    = 0;                  /* Peak buffer heap usage in cache lines. */
+static uint32_t         glBufAllocFailCnt = 0;                  /* Number of failed CyU3PDmaBufferAlloc calls. */
 
 #ifdef CYFXTX_ERRORDETECTION
 
@@ -145,6 +202,7 @@ static CyBool_t         glMemEnableChecks = CyFalse;            /* Whether check
 static uint32_t         glMemAllocCnt     = 0;                  /* Number of alloc operations performed. */
 static uint32_t         glMemFreeCnt      = 0;                  /* Number of free operations performed. */
 static MemBlockInfo    *glMemInUseList    = 0;                  /* List of all memory blocks in use. */
+static MemBlockInfo    *glMemCheckCursor  = 0;                  /* Next block for the incremental corruption check. */
 static CyU3PMemCorruptCallback glMemBadCb = 0;                  /* Callback for notification of corrupted memory. */
 
 /*
@@ -155,6 +213,7 @@ static CyBool_t         glBufMgrEnableChecks = CyFalse;         /* Whether check
 static uint32_t         glBufAllocCnt        = 0;               /* Number of alloc operations performed. */
 static uint32_t         glBufFreeCnt         = 0;               /* Number of free operations performed. */
 static MemBlockInfo    *glBufInUseList       = 0;               /* List of all memory blocks in use. */
+static MemBlockInfo    *glBufCheckCursor     = 0;               /* Next block for the incremental corruption check. */
 static CyU3PMemCorruptCallback glBufBadCb    = 0;               /* Callback for notification of corrupted memory. */
 
 #endif
@@ -168,7 +227,9 @@ static CyU3PMemCorruptCallback glBufBadCb    = 0;               /* Callback for
  * possible to define meaningful error handling in an application agnostic manner.
  *
  * These can be replaced with functions that update LEDs/GPIOs, use DebugPrint or even
- * reset FX3 as required by the application.
+ * reset FX3 as required by the application. When built with CYFX_USE_DTCM=1, the handlers
+ * run on the 128 byte ABT and UND stacks set up by cyfxdtcm.ld, which have to be enlarged
+ * there for a replacement that needs more stack.
  */
 
 /* Function    : CyU3PUndefinedHandler
@@ -294,6 +355,7 @@ CyU3PMemInit (
  *                firmware application. This function is used by the SDK internal drivers
  *                in addition to the application code itself.
  *                The default implementation makes use of the ThreadX byte pool services.
+ *                With CYFXTX_MEM_FILL defined, the block is filled with CYFXTX_MEM_FILL_BYTE.
  *                If memory leak and corruption checking is enabled, the implementation
  *                adds a 20 byte header and a 4 byte footer around the memory block.
  * Parameters   :
@@ -306,6 +368,7 @@ CyU3PMemAlloc (
 {
     void         *ret_p;
     uint32_t      status;
+    uint32_t      used;
 
 #ifdef CYFXTX_ERRORDETECTION
     MemBlockInfo *block_p;
@@ -332,6 +395,16 @@ CyU3PMemAlloc (
 
     if (status == CY_U3P_SUCCESS)
     {
+        /* Track the high water mark of the heap. */
+        used = CY_U3P_MEM_HEAP_SIZE - glMemBytePool.tx_byte_pool_available;
+        if (used > glMemPeakUsed)
+            glMemPeakUsed = used;
+
+#ifdef CYFXTX_MEM_FILL
+        /* Fill the block, so that the peak usage of the thread stacks can be measured. */
+        CyU3PMemSet ((uint8_t *)ret_p, CYFXTX_MEM_FILL_BYTE, size);
+#endif
+
 #ifdef CYFXTX_ERRORDETECTION
         if (glMemEnableChecks)
         {
@@ -357,6 +430,7 @@ CyU3PMemAlloc (
         return ret_p;
     }
 
+    glMemAllocFailCnt++;
     return (NULL);
 }
 
@@ -372,6 +446,7 @@ CyU3PMemFree (
 #ifdef CYFXTX_ERRORDETECTION
     MemBlockInfo *block_p;
     uint32_t     *endsig_p;
+    uint32_t      posture;
 #endif
 
     /* Validity check for the pointer. */
@@ -395,7 +470,11 @@ CyU3PMemFree (
 
         glMemFreeCnt++;
 
-        /* Update the in-use linked list to drop the freed-up block. */
+        /* Update the in-use linked list to drop the freed-up block. Interrupts are disabled so that
+           the incremental corruption check never sees a partially updated list. */
+        posture = tx_interrupt_control (TX_INT_DISABLE);
+        if (glMemCheckCursor == block_p)
+            glMemCheckCursor = block_p->prev_blk;
         if (block_p->next_blk != 0)
             block_p->next_blk->prev_blk = block_p->prev_blk;
         if (block_p->prev_blk != 0)
@@ -404,6 +483,7 @@ CyU3PMemFree (
         {
             glMemInUseList = block_p->prev_blk;
         }
+        tx_interrupt_control (posture);
 
         mem_p = (void *)block_p;
     }
@@ -451,6 +531,53 @@ CyU3PMemGetActiveList (
     return glMemInUseList;
 }
 
+/* Function     : CyU3PMemGetInUseBlocks
+ * Description  : Copy the id, size and address of in-use driver heap blocks into an
+ *                array. The in-use list is walked from the most recently allocated
+ *                block with interrupts disabled. Repeated calls with increasing
+ *                values of skip can be used to read out a long list in parts.
+ * Parameters   :
+ *                rec_p    : Array to be filled with the block information.
+ *                skip     : Number of blocks at the head of the list to skip.
+ *                maxCount : Size of the array.
+ * Return Value : Number of records filled in.
+ */
+uint32_t
+CyU3PMemGetInUseBlocks (
+        CyFxBlockRecord_t *rec_p,
+        uint32_t           skip,
+        uint32_t           maxCount)
+{
+    MemBlockInfo *block_p;
+    uint32_t      posture, count = 0;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+
+    block_p = glMemInUseList;
+    while ((block_p != 0) && (count < maxCount))
+    {
+        if (((uint32_t)block_p < CY_U3P_MEM_HEAP_BASE) || ((uint32_t)block_p >= CY_U3P_BUFFER_HEAP_BASE))
+            break;
+
+        if (skip != 0)
+        {
+            skip--;
+        }
+        else
+        {
+            rec_p[count].allocId   = block_p->alloc_id;
+            rec_p[count].allocSize = block_p->alloc_size;
+            rec_p[count].address   = (uint32_t)block_p;
+            count++;
+        }
+
+        block_p = block_p->prev_blk;
+    }
+
+    tx_interrupt_control (posture);
+    return count;
+}
+
 /* Function     : CyU3PMemCorruptionCheck
  * Description  : Check all in-use memory blocks for memory corruption. The
  *                in-use memory list is traversed; and each block is checked
@@ -493,6 +620,74 @@ CyU3PMemCorruptionCheck (
     return CY_U3P_SUCCESS;
 }
 
+/* Function     : CyU3PMemCorruptionCheckStep
+ * Description  : Incremental version of CyU3PMemCorruptionCheck. Each call checks
+ *                at most maxBlocks in-use blocks, continuing from where the previous
+ *                call stopped. A new pass over the in-use list is started once the
+ *                end of the list is reached; blocks allocated during a pass are
+ *                checked in the next pass.
+ *                The blocks are checked with interrupts disabled. The time taken
+ *                is bounded by maxBlocks times the cost of one block check, which
+ *                is two signature reads and a range check on the block pointer.
+ *                This function can be called from thread or timer context.
+ * Parameters   :
+ *                maxBlocks : Maximum number of blocks to check in this call.
+ *                checked_p : Optional parameter to be filled with the number of
+ *                            blocks checked.
+ * Return Value : CY_U3P_SUCCESS or CY_U3P_ERROR_FAILURE depending on whether
+ *                corruption is found or not.
+ */
+CyU3PReturnStatus_t
+CyU3PMemCorruptionCheckStep (
+        uint32_t  maxBlocks,
+        uint32_t *checked_p)
+{
+    MemBlockInfo *block_p, *bad_p = 0;
+    uint32_t     *mem_p;
+    uint32_t      posture, count = 0;
+    CyU3PReturnStatus_t stat = CY_U3P_SUCCESS;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+
+    /* Start a new pass at the head of the list if the previous pass is complete. */
+    if (glMemCheckCursor == 0)
+        glMemCheckCursor = glMemInUseList;
+
+    block_p = glMemCheckCursor;
+    while ((block_p != 0) && (count < maxBlocks))
+    {
+        if (((uint32_t)block_p < CY_U3P_MEM_HEAP_BASE) || ((uint32_t)block_p >= CY_U3P_BUFFER_HEAP_BASE))
+        {
+            stat = CY_U3P_ERROR_FAILURE;
+            break;
+        }
+
+        count++;
+        mem_p = (uint32_t *)((uint8_t *)block_p + block_p->alloc_size - sizeof (uint32_t));
+        if ((block_p->start_sig != CY_U3P_MEM_START_SIG) || (*mem_p != CY_U3P_MEM_END_SIG))
+        {
+            bad_p = block_p;
+            stat  = CY_U3P_ERROR_FAILURE;
+            break;
+        }
+
+        block_p = block_p->prev_blk;
+    }
+
+    /* Once we find any corruption, we cannot rely on the list pointers any more. Start again
+       from the head of the list on the next call. */
+    glMemCheckCursor = (stat == CY_U3P_SUCCESS) ? block_p : 0;
+    tx_interrupt_control (posture);
+
+    if ((bad_p != 0) && (glMemBadCb != 0))
+        glMemBadCb ((void *)((uint8_t *)bad_p + sizeof (MemBlockInfo)));
+
+    if (checked_p != 0)
+        *checked_p = count;
+
+    return stat;
+}
+
 #endif
 
 /* Function     : CyU3PMemSet
@@ -542,13 +737,15 @@ CyU3PMemSet (
  *                aligned; and performs a byte-by-byte copy.
  *                No checks are performed on the parameters because even a NULL-pointer
  *                is valid on the FX3 device.
+ *                The function is run from I-TCM as it copies the video data on the
+ *                streaming path.
  * Parameters   :
  *                dest  : Pointer to destination memory block.
  *                src   : Pointer to source memory block.
  *                count : Size of memory block.
  * Return Value : None
  */
-void
+CY_FX_ITCM_CODE void
 CyU3PMemCopy (
         uint8_t  *dest, 
         uint8_t  *src,
@@ -656,7 +853,7 @@ CyU3PMemCmp (
 /* Function     : CyU3PBufEnableChecks
  * Description  : Enable memory leak and corruption checks in the buffer heap allocator.
  *                Enabling the checks will cause the memory required for each allocated
- *                block to increase by 24 bytes; and the allocation operation to take
+ *                block to increase by 36 bytes; and the allocation operation to take
  *                additional time.
  * Parameters   :
  *                enable : Whether to enable memory leak and corruption checks.
@@ -673,7 +870,7 @@ CyU3PBufEnableChecks (
 {
     CyU3PReturnStatus_t stat = CY_U3P_ERROR_ALREADY_STARTED;
 
-    if (glBufferManager.usedStatus == 0)
+    if (glBufferManager.numRegions == 0)
     {
         glBufMgrEnableChecks = enable;
         glBufBadCb           = cb;
@@ -685,6 +882,49 @@ CyU3PBufEnableChecks (
 
 #endif
 
+/* Function    : CyU3PDmaBufRegionInit
+ * Description : Helper function for the DMA buffer manager. Sets up the status
+ *               bitmap for one memory region.
+ * Return Value: CyTrue if the region was set up, CyFalse otherwise.
+ */
+static CyBool_t
+CyU3PDmaBufRegionInit (
+        CyFxBufRegion_t *region_p,
+        uint32_t         startAddr,
+        uint32_t         regionSize)
+{
+    uint32_t size, lines;
+    uint32_t tmp;
+
+    /* Allocate the memory buffer to be used to track memory status.
+       We need one bit per cache line of memory buffer space. Since a DWORD
+       array is being used for the status, round up to the necessary number of
+       DWORDs. */
+    lines = regionSize / FX3_CACHE_LINE_SZ;
+    size  = ROUND_UP (lines, 32) / 32;
+    region_p->usedStatus = (uint32_t *)CyU3PMemAlloc (size * sizeof (uint32_t));
+    if (region_p->usedStatus == 0)
+    {
+        return CyFalse;
+    }
+
+    /* Initially mark all memory as available. If there are any status bits
+       beyond the valid memory range, mark these as unavailable. */
+    CyU3PMemSet ((uint8_t *)region_p->usedStatus, 0, (size * sizeof (uint32_t)));
+    if ((lines & 31) != 0)
+    {
+        tmp = 32 - (lines & 31);
+        region_p->usedStatus[size - 1] = ~((1 << tmp) - 1);
+    }
+
+    /* Initialize the start address and region size variables. */
+    region_p->startAddr  = startAddr;
+    region_p->regionSize = regionSize;
+    region_p->statusSize = size;
+    region_p->searchPos  = 0;
+    return CyTrue;
+}
+
 /* Function    : CyU3PDmaBufferInit
  * Description : This function initializes the custom heap used for DMA buffer allocation.
  *               These functions use a home-grown allocator in order to ensure that all
@@ -697,11 +937,10 @@ void
 CyU3PDmaBufferInit (
         void)
 {
-    uint32_t status, size;
-    uint32_t tmp;
+    uint32_t status, i;
 
     /* If buffer manager has already been initialized, just return. */
-    if ((glBufferManager.startAddr != 0) && (glBufferManager.regionSize != 0))
+    if (glBufferManager.numRegions != 0)
     {
         return;
     }
@@ -715,33 +954,23 @@ CyU3PDmaBufferInit (
 
     /* No threads are running at this point in time. There is no need to
        get the mutex. */
-
-    /* Allocate the memory buffer to be used to track memory status.
-       We need one bit per cache line of memory buffer space. Since a DWORD
-       array is being used for the status, round up to the necessary number of
-       DWORDs. */
-    size = ROUND_UP ((CY_U3P_BUFFER_HEAP_SIZE / FX3_CACHE_LINE_SZ), 32) / 32;
-    glBufferManager.usedStatus = (uint32_t *)CyU3PMemAlloc (size * sizeof (uint32_t));
-    if (glBufferManager.usedStatus == 0)
+    glBufferManager.usedLines = 0;
+    for (i = 0; i < (sizeof (glBufRegionList) / sizeof (glBufRegionList[0])); i++)
     {
-        CyU3PMutexDestroy (&glBufferManager.lock);
-        return;
+        if (!CyU3PDmaBufRegionInit (&glBufferManager.region[glBufferManager.numRegions],
+                    glBufRegionList[i][0], glBufRegionList[i][1]))
+        {
+            break;
+        }
+
+        glBufferManager.numRegions++;
     }
 
-    /* Initially mark all memory as available. If there are any status bits
-       beyond the valid memory range, mark these as unavailable. */
-    CyU3PMemSet ((uint8_t *)glBufferManager.usedStatus, 0, (size * sizeof (uint32_t)));
-    if (((CY_U3P_BUFFER_HEAP_SIZE / FX3_CACHE_LINE_SZ) & 31) != 0)
+    /* The allocator cannot be used if even the primary region could not be set up. */
+    if (glBufferManager.numRegions == 0)
     {
-        tmp = 32 - ((CY_U3P_BUFFER_HEAP_SIZE / FX3_CACHE_LINE_SZ) & 31);
-        glBufferManager.usedStatus[size - 1] = ~((1 << tmp) - 1);
+        CyU3PMutexDestroy (&glBufferManager.lock);
     }
-
-    /* Initialize the start address and region size variables. */
-    glBufferManager.startAddr  = CY_U3P_BUFFER_HEAP_BASE;
-    glBufferManager.regionSize = CY_U3P_BUFFER_HEAP_SIZE;
-    glBufferManager.statusSize = size;
-    glBufferManager.searchPos  = 0;
 }
 
 /* Function    : CyU3PDmaBufferDeInit
@@ -754,7 +983,7 @@ void
 CyU3PDmaBufferDeInit (
         void)
 {
-    uint32_t status;
+    uint32_t status, i;
 
     /* Get the mutex lock. */
     if (CyU3PThreadIdentify ())
@@ -772,17 +1001,20 @@ CyU3PDmaBufferDeInit (
     }
 
     /* Free memory and zero out variables. */
-    CyU3PMemFree (glBufferManager.usedStatus);
-    glBufferManager.usedStatus = 0;
-    glBufferManager.startAddr  = 0;
-    glBufferManager.regionSize = 0;
-    glBufferManager.statusSize = 0;
+    for (i = 0; i < glBufferManager.numRegions; i++)
+    {
+        CyU3PMemFree (glBufferManager.region[i].usedStatus);
+        CyU3PMemSet ((uint8_t *)&glBufferManager.region[i], 0, sizeof (CyFxBufRegion_t));
+    }
+    glBufferManager.numRegions = 0;
+    glBufferManager.usedLines  = 0;
 
 #ifdef CYFXTX_ERRORDETECTION
     /* Clear status tracking variables. */
-    glBufAllocCnt  = 0;
-    glBufFreeCnt   = 0;
-    glBufInUseList = 0;
+    glBufAllocCnt    = 0;
+    glBufFreeCnt     = 0;
+    glBufInUseList   = 0;
+    glBufCheckCursor = 0;
 #endif
 
     /* Free up and destroy the mutex variable. */
@@ -796,6 +1028,7 @@ CyU3PDmaBufferDeInit (
  */
 static void
 CyU3PDmaBufMgrSetStatus (
+        CyFxBufRegion_t *region_p,
         uint32_t startPos,
         uint32_t numBits,
         CyBool_t value)
@@ -815,11 +1048,11 @@ CyU3PDmaBufMgrSetStatus (
     {
         if (value)
         {
-            glBufferManager.usedStatus[wordnum] |= mask;
+            region_p->usedStatus[wordnum] |= mask;
         }
         else
         {
-            glBufferManager.usedStatus[wordnum] &= ~mask;
+            region_p->usedStatus[wordnum] &= ~mask;
         }
 
         wordnum++;
@@ -839,12 +1072,111 @@ CyU3PDmaBufMgrSetStatus (
     }
 }
 
+/* Function    : CyU3PDmaBufRegionAlloc
+ * Description : Helper function for the DMA buffer manager. Finds and marks a
+ *               block of the requested number of cache lines within one region.
+ * Return Value: Pointer to the block, or NULL if the region has no free block
+ *               that is large enough.
+ */
+static void *
+CyU3PDmaBufRegionAlloc (
+        CyFxBufRegion_t *region_p,
+        uint32_t         size)
+{
+    uint32_t tmp;
+    uint32_t wordnum, bitnum;
+    uint32_t count, start = 0;
+
+    /* Search through the status array to find the first block that fits the need. */
+    wordnum = region_p->searchPos;
+    bitnum  = 0;
+    count   = 0;
+    tmp     = 0;
+
+    /* Stop searching once we have checked all of the words. */
+    while (tmp < region_p->statusSize)
+    {
+        if ((region_p->usedStatus[wordnum] & (1 << bitnum)) == 0)
+        {
+            if (count == 0)
+            {
+                start = (wordnum << 5) + bitnum + 1;
+            }
+            count++;
+            if (count == (size + 1))
+            {
+                /* The last bit corresponding to the allocated memory is left as zero.
+                   This allows us to identify the end of the allocated block while freeing
+                   the memory. We need to search for one additional zero while allocating
+                   to account for this hack. */
+                region_p->searchPos = wordnum;
+                break;
+            }
+        }
+        else
+        {
+            count = 0;
+        }
+
+        bitnum++;
+        if (bitnum == 32)
+        {
+            bitnum = 0;
+            wordnum++;
+            tmp++;
+            if (wordnum == region_p->statusSize)
+            {
+                /* Wrap back to the top of the array. */
+                wordnum = 0;
+                count   = 0;
+            }
+        }
+    }
+
+    if (count != (size + 1))
+    {
+        return 0;
+    }
+
+    /* Mark the memory region identified as occupied and return the pointer. */
+    CyU3PDmaBufMgrSetStatus (region_p, start, size - 1, CyTrue);
+    glBufferManager.usedLines += size;
+    if (glBufferManager.usedLines > glBufPeakLines)
+        glBufPeakLines = glBufferManager.usedLines;
+    return (void *)(region_p->startAddr + (start << 5));
+}
+
+/* Function    : CyU3PDmaBufFindRegion
+ * Description : Helper function for the DMA buffer manager. Identifies the region
+ *               that a buffer address belongs to.
+ * Return Value: Pointer to the region, or NULL if the address is not in the buffer heap.
+ */
+static CyFxBufRegion_t *
+CyU3PDmaBufFindRegion (
+        uint32_t addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < glBufferManager.numRegions; i++)
+    {
+        if ((addr >= glBufferManager.region[i].startAddr) &&
+                (addr < (glBufferManager.region[i].startAddr + glBufferManager.region[i].regionSize)))
+        {
+            return &glBufferManager.region[i];
+        }
+    }
+
+    return 0;
+}
+
 /* Function     : CyU3PDmaBufferAlloc
  * Description  : This function allocates memory required for DMA buffers required by the
  *                firmware application. This function is used by the SDK internal drivers
  *                in addition to the application code itself.
+ *                The regions in the buffer heap are searched in order, and the buffer is
+ *                taken from the first region that has a large enough free block.
  *                If memory leak and corruption checking is enabled, the implementation
- *                adds a 20 byte header and a 4 byte footer around each memory block.
+ *                adds a one cache line header and a 4 byte footer around each memory block.
  * Parameters   :
  *                size : Size of memory required in bytes.
  * Return Value : Pointer to the allocated memory block.
@@ -857,9 +1189,8 @@ CyU3PDmaBufferAlloc (
     MemBlockInfo *block_p;
 #endif
 
-    uint32_t tmp;
-    uint32_t wordnum, bitnum;
-    uint32_t count, start = 0;
+    uint32_t tmp, i;
+    uint32_t lines;
     uint32_t blk_size = (uint32_t)size;
     void *ptr = 0;
 
@@ -879,7 +1210,7 @@ CyU3PDmaBufferAlloc (
     }
 
     /* Make sure the buffer manager has been initialized. */
-    if ((glBufferManager.startAddr == 0) || (glBufferManager.regionSize == 0))
+    if (glBufferManager.numRegions == 0)
     {
         CyU3PMutexPut (&glBufferManager.lock);
         return ptr;
@@ -890,87 +1221,47 @@ CyU3PDmaBufferAlloc (
     {
         /* Using a 32-bit variable here to allow for addition of header on top of a maximum sized allocation. */
         blk_size  = ROUND_UP (blk_size, 4);
-        blk_size += sizeof (MemBlockInfo) + sizeof (uint32_t);
+        blk_size += CY_U3P_BUF_HDR_SIZE + sizeof (uint32_t);
     }
 #endif
 
     /* Find the number of cache lines required. The minimum size that can be handled is 2 cache lines. */
-    size = (blk_size <= FX3_CACHE_LINE_SZ) ? 2 : ((blk_size + FX3_CACHE_LINE_SZ - 1) / FX3_CACHE_LINE_SZ);
-
-    /* Search through the status array to find the first block that fits the need. */
-    wordnum = glBufferManager.searchPos;
-    bitnum  = 0;
-    count   = 0;
-    tmp     = 0;
+    lines = (blk_size <= FX3_CACHE_LINE_SZ) ? 2 : ((blk_size + FX3_CACHE_LINE_SZ - 1) / FX3_CACHE_LINE_SZ);
 
-    /* Stop searching once we have checked all of the words. */
-    while (tmp < glBufferManager.statusSize)
+    for (i = 0; (i < glBufferManager.numRegions) && (ptr == 0); i++)
     {
-        if ((glBufferManager.usedStatus[wordnum] & (1 << bitnum)) == 0)
-        {
-            if (count == 0)
-            {
-                start = (wordnum << 5) + bitnum + 1;
-            }
-            count++;
-            if (count == (uint16_t)(size + 1))
-            {
-                /* The last bit corresponding to the allocated memory is left as zero.
-                   This allows us to identify the end of the allocated block while freeing
-                   the memory. We need to search for one additional zero while allocating
-                   to account for this hack. */
-                glBufferManager.searchPos = wordnum;
-                break;
-            }
-        }
-        else
-        {
-            count = 0;
-        }
-
-        bitnum++;
-        if (bitnum == 32)
-        {
-            bitnum = 0;
-            wordnum++;
-            tmp++;
-            if (wordnum == glBufferManager.statusSize)
-            {
-                /* Wrap back to the top of the array. */
-                wordnum = 0;
-                count   = 0;
-            }
-        }
+        ptr = CyU3PDmaBufRegionAlloc (&glBufferManager.region[i], lines);
     }
 
-    if (count == (uint16_t)(size + 1))
-    {
-        /* Mark the memory region identified as occupied and return the pointer. */
-        CyU3PDmaBufMgrSetStatus (start, size - 1, CyTrue);
-        ptr = (void *)(glBufferManager.startAddr + (start << 5));
+    if (ptr == 0)
+        glBufAllocFailCnt++;
 
 #ifdef CYFXTX_ERRORDETECTION
-        if (glBufMgrEnableChecks)
-        {
-            /* Store the header information used for leak and corruption checks. */
-            block_p = (MemBlockInfo *)ptr;
-            block_p->alloc_id        = glBufAllocCnt++;
-            block_p->alloc_size      = blk_size;
-            block_p->prev_blk        = glBufInUseList;
-            block_p->next_blk        = 0;
-            block_p->start_sig       = CY_U3P_MEM_START_SIG;
-            if (glBufInUseList != 0)
-                glBufInUseList->next_blk = block_p;
-            glBufInUseList           = block_p;
-
-            /* Add the end block signature as a footer. */
-            ((uint32_t *)block_p)[BYTE_TO_DWORD (blk_size) - 1] = CY_U3P_MEM_END_SIG;
-
-            /* Update the return pointer to skip the header created. */
-            ptr = (void *)((uint8_t *)block_p + sizeof (MemBlockInfo));
-        }
-#endif
+    if ((ptr != 0) && (glBufMgrEnableChecks))
+    {
+        /* Store the header information used for leak and corruption checks. */
+        block_p = (MemBlockInfo *)ptr;
+        block_p->alloc_id        = glBufAllocCnt++;
+        block_p->alloc_size      = blk_size;
+        block_p->prev_blk        = glBufInUseList;
+        block_p->next_blk        = 0;
+        block_p->start_sig       = CY_U3P_MEM_START_SIG;
+        if (glBufInUseList != 0)
+            glBufInUseList->next_blk = block_p;
+        glBufInUseList           = block_p;
+
+        /* Add the end block signature as a footer. */
+        ((uint32_t *)block_p)[BYTE_TO_DWORD (blk_size) - 1] = CY_U3P_MEM_END_SIG;
+
+        /* The footer may share a cache line with the end of the buffer. Write it back now, so
+           that invalidating the buffer before a DMA transfer into it does not discard it. */
+        CyU3PSysCleanDRegion ((uint32_t *)((uint32_t)block_p + ((blk_size - 1) & ~(FX3_CACHE_LINE_SZ - 1))),
+                FX3_CACHE_LINE_SZ);
+
+        /* Update the return pointer to skip the header created. */
+        ptr = (void *)((uint8_t *)block_p + CY_U3P_BUF_HDR_SIZE);
     }
+#endif
 
     CyU3PMutexPut (&glBufferManager.lock);
     return (ptr);
@@ -991,6 +1282,7 @@ CyU3PDmaBufferFree (
     uint32_t     *sig_p;
 #endif
 
+    CyFxBufRegion_t *region_p;
     uint32_t status, start, count;
     uint32_t wordnum, bitnum;
     int      retVal = -1;
@@ -1018,7 +1310,7 @@ CyU3PDmaBufferFree (
     /* Update the structures used for leak checking. */
     if (glBufMgrEnableChecks)
     {
-        block_p = (MemBlockInfo *)((uint8_t *)buffer - sizeof (MemBlockInfo));
+        block_p = (MemBlockInfo *)((uint8_t *)buffer - CY_U3P_BUF_HDR_SIZE);
         sig_p   = (uint32_t *)((uint8_t *)block_p + block_p->alloc_size - sizeof (uint32_t));
         if ((block_p->start_sig != CY_U3P_MEM_START_SIG) || (*sig_p != CY_U3P_MEM_END_SIG))
         {
@@ -1030,6 +1322,8 @@ CyU3PDmaBufferFree (
         glBufFreeCnt++;
 
         /* Update the in-use linked list to drop the freed-up block. */
+        if (glBufCheckCursor == block_p)
+            glBufCheckCursor = block_p->prev_blk;
         if (block_p->next_blk != 0)
             block_p->next_blk->prev_blk = block_p->prev_blk;
         if (block_p->prev_blk != 0)
@@ -1043,18 +1337,19 @@ CyU3PDmaBufferFree (
     }
 #endif
 
-    /* If the buffer address is within the range specified, count the number of consecutive ones and
+    /* If the buffer address is within one of the regions, count the number of consecutive ones and
        clear them. */
-    start = (uint32_t)buffer;
-    if ((start > glBufferManager.startAddr) && (start < (glBufferManager.startAddr + glBufferManager.regionSize)))
+    start    = (uint32_t)buffer;
+    region_p = CyU3PDmaBufFindRegion (start);
+    if ((region_p != 0) && (start > region_p->startAddr))
     {
-        start = ((start - glBufferManager.startAddr) >> 5);
+        start = ((start - region_p->startAddr) >> 5);
 
         wordnum = (start >> 5);
         bitnum  = (start & 0x1F);
         count   = 0;
 
-        while ((wordnum < glBufferManager.statusSize) && ((glBufferManager.usedStatus[wordnum] & (1 << bitnum)) != 0))
+        while ((wordnum < region_p->statusSize) && ((region_p->usedStatus[wordnum] & (1 << bitnum)) != 0))
         {
             count++;
             bitnum++;
@@ -1065,11 +1360,14 @@ CyU3PDmaBufferFree (
             }
         }
 
-        CyU3PDmaBufMgrSetStatus (start, count, CyFalse);
+        CyU3PDmaBufMgrSetStatus (region_p, start, count, CyFalse);
+
+        /* The block also owned the terminating cache line which was left clear. */
+        glBufferManager.usedLines -= (count + 1);
 
         /* Start the next buffer search at the top of the heap. This can help reduce fragmentation in cases where
            most of the heap is allocated and then freed as a whole. */
-        glBufferManager.searchPos = 0;
+        region_p->searchPos = 0;
         retVal = 0;
     }
 
@@ -1078,6 +1376,197 @@ CyU3PDmaBufferFree (
     return retVal;
 }
 
+/* Function     : CyU3PBufGetCapacity
+ * Description  : Get the size of the buffer heap and the amount of space that is
+ *                currently not allocated. The free space may be split across
+ *                several regions and blocks, so a single allocation of this size
+ *                is not guaranteed to succeed.
+ * Parameters   :
+ *                totalSize_p  : Parameter to be filled with the total size of all regions.
+ *                freeSize_p   : Parameter to be filled with the unallocated space in bytes.
+ *                numRegions_p : Parameter to be filled with the number of regions.
+ * Return Value : None
+ */
+void
+CyU3PBufGetCapacity (
+        uint32_t *totalSize_p,
+        uint32_t *freeSize_p,
+        uint32_t *numRegions_p)
+{
+    uint32_t total = 0, i;
+
+    for (i = 0; i < glBufferManager.numRegions; i++)
+    {
+        total += glBufferManager.region[i].regionSize;
+    }
+
+    if (totalSize_p != 0)
+        *totalSize_p = total;
+    if (freeSize_p != 0)
+        *freeSize_p = total - (glBufferManager.usedLines * FX3_CACHE_LINE_SZ);
+    if (numRegions_p != 0)
+        *numRegions_p = glBufferManager.numRegions;
+}
+
+/* Function     : CyU3PBootAreaGet
+ * Description  : Get the RAM area reserved for the 2-stage boot-loader. The area is not
+ *                touched by the firmware image or the .bss initialization, and can be used
+ *                by the application when the persistent boot-loader is not in use.
+ * Parameters   :
+ *                size_p : Parameter to be filled with the size of the area in bytes.
+ * Return Value : Start of the area, or NULL if it has been given to the buffer heap.
+ */
+void *
+CyU3PBootAreaGet (
+        uint32_t *size_p)
+{
+#ifdef CYFXTX_RECLAIM_BOOT_AREA
+    *size_p = 0;
+    return NULL;
+#else
+    *size_p = CY_U3P_BOOT_AREA_SIZE;
+    return (void *)CY_U3P_SYS_MEM_TOP;
+#endif
+}
+
+/* Function     : CyU3PMemGetStats
+ * Description  : Get usage and fragmentation information for the driver heap. The
+ *                byte pool is walked with interrupts disabled to find the free
+ *                blocks, and the time taken grows with the number of blocks in the
+ *                pool. This should not be called from time critical code.
+ * Parameters   :
+ *                stats_p : Structure to be filled with the heap statistics.
+ * Return Value : None
+ */
+void
+CyU3PMemGetStats (
+        CyFxHeapStats_t *stats_p)
+{
+    uint8_t  *block_p, *next_p;
+    uint32_t  size, posture;
+
+    if ((stats_p == 0) || (!glMemPoolInit))
+        return;
+
+    CyU3PMemSet ((uint8_t *)stats_p, 0, sizeof (CyFxHeapStats_t));
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+
+    stats_p->totalSize      = CY_U3P_MEM_HEAP_SIZE;
+    stats_p->usedSize       = CY_U3P_MEM_HEAP_SIZE - glMemBytePool.tx_byte_pool_available;
+    stats_p->peakUsedSize   = glMemPeakUsed;
+    stats_p->allocFailCount = glMemAllocFailCnt;
+
+    block_p = glMemBytePool.tx_byte_pool_start;
+    do
+    {
+        next_p = *((uint8_t **)block_p);
+
+        /* Stop if the block list has been corrupted. */
+        if ((next_p < (uint8_t *)CY_U3P_MEM_HEAP_BASE) || (next_p >= (uint8_t *)CY_U3P_BUFFER_HEAP_BASE))
+            break;
+
+        if (*((uint32_t *)(block_p + sizeof (uint8_t *))) == CY_U3P_BYTE_BLOCK_FREE)
+        {
+            size = (next_p > block_p) ? ((uint32_t)(next_p - block_p) - CY_U3P_BYTE_BLOCK_HDR_SIZE) : 0;
+            stats_p->freeFragments++;
+            if (size > stats_p->largestFree)
+                stats_p->largestFree = size;
+        }
+
+        block_p = next_p;
+    } while (block_p != glMemBytePool.tx_byte_pool_start);
+
+    tx_interrupt_control (posture);
+}
+
+/* Function    : CyU3PBufStatsAddRun
+ * Description : Helper function for CyU3PBufGetStats. Accounts for a run of clear
+ *               status bits.
+ */
+static void
+CyU3PBufStatsAddRun (
+        CyFxHeapStats_t *stats_p,
+        uint32_t         run)
+{
+    if (run > 1)
+    {
+        stats_p->freeFragments++;
+        stats_p->largestFree = CY_U3P_MAX (stats_p->largestFree, (run - 1) * FX3_CACHE_LINE_SZ);
+    }
+}
+
+/* Function     : CyU3PBufGetStats
+ * Description  : Get usage and fragmentation information for the buffer heap. The
+ *                status bitmaps of all regions are scanned while holding the buffer
+ *                manager lock. A free block of N cache lines shows up as a run of
+ *                N + 1 clear bits, as the allocator leaves the last line of each
+ *                allocated block clear.
+ * Parameters   :
+ *                stats_p : Structure to be filled with the heap statistics.
+ * Return Value : None
+ */
+void
+CyU3PBufGetStats (
+        CyFxHeapStats_t *stats_p)
+{
+    CyFxBufRegion_t *region_p;
+    uint32_t i, wordnum, bitnum, word, run;
+
+    if ((stats_p == 0) || (glBufferManager.numRegions == 0))
+        return;
+
+    CyU3PMemSet ((uint8_t *)stats_p, 0, sizeof (CyFxHeapStats_t));
+    if (CyU3PMutexGet (&glBufferManager.lock, CY_U3P_BUFFER_ALLOC_TIMEOUT) != CY_U3P_SUCCESS)
+        return;
+
+    CyU3PBufGetCapacity (&stats_p->totalSize, 0, 0);
+    stats_p->usedSize       = glBufferManager.usedLines * FX3_CACHE_LINE_SZ;
+    stats_p->peakUsedSize   = glBufPeakLines * FX3_CACHE_LINE_SZ;
+    stats_p->allocFailCount = glBufAllocFailCnt;
+
+    for (i = 0; i < glBufferManager.numRegions; i++)
+    {
+        region_p = &glBufferManager.region[i];
+        run      = 0;
+
+        /* A run of clear bits can span several DWORDs of the bitmap. */
+        for (wordnum = 0; wordnum < region_p->statusSize; wordnum++)
+        {
+            word = region_p->usedStatus[wordnum];
+            if (word == 0)
+            {
+                run += 32;
+                continue;
+            }
+
+            if (word == 0xFFFFFFFFU)
+            {
+                CyU3PBufStatsAddRun (stats_p, run);
+                run = 0;
+                continue;
+            }
+
+            for (bitnum = 0; bitnum < 32; bitnum++)
+            {
+                if ((word & (1 << bitnum)) == 0)
+                {
+                    run++;
+                }
+                else
+                {
+                    CyU3PBufStatsAddRun (stats_p, run);
+                    run = 0;
+                }
+            }
+        }
+
+        CyU3PBufStatsAddRun (stats_p, run);
+    }
+
+    CyU3PMutexPut (&glBufferManager.lock);
+}
+
 /* Function    : CyU3PFreeHeaps
  * Description : This function de-initializes both driver and buffer heap allocators.
  *               This is called from the SDK library and is not expected to be called
@@ -1094,11 +1583,17 @@ CyU3PFreeHeaps (
     CyU3PBytePoolDestroy (&glMemBytePool);
     glMemPoolInit = CyFalse;
 
+    glMemPeakUsed     = 0;
+    glMemAllocFailCnt = 0;
+    glBufPeakLines    = 0;
+    glBufAllocFailCnt = 0;
+
 #ifdef CYFXTX_ERRORDETECTION
     /* Clear status tracking variables. */
-    glMemAllocCnt  = 0;
-    glMemFreeCnt   = 0;
-    glMemInUseList = 0;
+    glMemAllocCnt    = 0;
+    glMemFreeCnt     = 0;
+    glMemInUseList   = 0;
+    glMemCheckCursor = 0;
 #endif
 }
 
@@ -1139,6 +1634,55 @@ CyU3PBufGetActiveList (
     return glBufInUseList;
 }
 
+/* Function     : CyU3PBufGetInUseBlocks
+ * Description  : Copy the id, size and address of in-use buffer heap blocks into an
+ *                array. The in-use list is walked from the most recently allocated
+ *                block while holding the buffer manager lock. Repeated calls with
+ *                increasing values of skip can be used to read out a long list in parts.
+ * Parameters   :
+ *                rec_p    : Array to be filled with the block information.
+ *                skip     : Number of blocks at the head of the list to skip.
+ *                maxCount : Size of the array.
+ * Return Value : Number of records filled in.
+ */
+uint32_t
+CyU3PBufGetInUseBlocks (
+        CyFxBlockRecord_t *rec_p,
+        uint32_t           skip,
+        uint32_t           maxCount)
+{
+    MemBlockInfo *block_p;
+    uint32_t      count = 0;
+
+    if ((glBufferManager.numRegions == 0) ||
+            (CyU3PMutexGet (&glBufferManager.lock, CY_U3P_BUFFER_ALLOC_TIMEOUT) != CY_U3P_SUCCESS))
+        return 0;
+
+    block_p = glBufInUseList;
+    while ((block_p != 0) && (count < maxCount))
+    {
+        if (CyU3PDmaBufFindRegion ((uint32_t)block_p) == 0)
+            break;
+
+        if (skip != 0)
+        {
+            skip--;
+        }
+        else
+        {
+            rec_p[count].allocId   = block_p->alloc_id;
+            rec_p[count].allocSize = block_p->alloc_size;
+            rec_p[count].address   = (uint32_t)block_p;
+            count++;
+        }
+
+        block_p = block_p->prev_blk;
+    }
+
+    CyU3PMutexPut (&glBufferManager.lock);
+    return count;
+}
+
 /* Function     : CyU3PBufCorruptionCheck
  * Description  : Check all in-use memory blocks for memory corruption. The
  *                in-use memory list is traversed; and each block is checked
@@ -1161,14 +1705,14 @@ CyU3PBufCorruptionCheck (
     block_p = glBufInUseList;
     while (block_p != 0)
     {
-        if (((uint32_t)block_p < CY_U3P_BUFFER_HEAP_BASE) || ((uint32_t)block_p >= CY_U3P_SYS_MEM_TOP))
+        if (CyU3PDmaBufFindRegion ((uint32_t)block_p) == 0)
             return CY_U3P_ERROR_FAILURE;
 
         mem_p = (uint32_t *)((uint8_t *)block_p + block_p->alloc_size - sizeof (uint32_t));
         if ((block_p->start_sig != CY_U3P_MEM_START_SIG) || (*mem_p != CY_U3P_MEM_END_SIG))
         {
             if (glBufBadCb != 0)
-                glBufBadCb ((void *)((uint8_t *)block_p + sizeof (MemBlockInfo)));
+                glBufBadCb ((void *)((uint8_t *)block_p + CY_U3P_BUF_HDR_SIZE));
 
             /* Once we find any corruption, we cannot rely on the list pointers any more. */
             return CY_U3P_ERROR_FAILURE;
@@ -1181,6 +1725,82 @@ CyU3PBufCorruptionCheck (
     return CY_U3P_SUCCESS;
 }
 
+/* Function     : CyU3PBufCorruptionCheckStep
+ * Description  : Incremental version of CyU3PBufCorruptionCheck. Each call checks
+ *                at most maxBlocks in-use blocks, continuing from where the previous
+ *                call stopped. A new pass over the in-use list is started once the
+ *                end of the list is reached.
+ *                The buffer manager lock is taken without waiting; no blocks are
+ *                checked if an allocation is in progress. The time taken is bounded
+ *                by maxBlocks times the cost of one block check, which is two
+ *                signature reads and a region lookup on the block pointer.
+ *                As it takes a mutex, this function can only be called from thread
+ *                context.
+ * Parameters   :
+ *                maxBlocks : Maximum number of blocks to check in this call.
+ *                checked_p : Optional parameter to be filled with the number of
+ *                            blocks checked.
+ * Return Value : CY_U3P_SUCCESS if no corruption is found, CY_U3P_ERROR_FAILURE
+ *                if corruption is found, CY_U3P_ERROR_TIMEOUT if the check was
+ *                skipped because the lock is taken.
+ */
+CyU3PReturnStatus_t
+CyU3PBufCorruptionCheckStep (
+        uint32_t  maxBlocks,
+        uint32_t *checked_p)
+{
+    MemBlockInfo *block_p, *bad_p = 0;
+    uint32_t     *mem_p;
+    uint32_t      count = 0;
+    CyU3PReturnStatus_t stat = CY_U3P_SUCCESS;
+
+    if (checked_p != 0)
+        *checked_p = 0;
+
+    if (glBufferManager.numRegions == 0)
+        return CY_U3P_SUCCESS;
+    if (CyU3PMutexGet (&glBufferManager.lock, CYU3P_NO_WAIT) != CY_U3P_SUCCESS)
+        return CY_U3P_ERROR_TIMEOUT;
+
+    /* Start a new pass at the head of the list if the previous pass is complete. */
+    if (glBufCheckCursor == 0)
+        glBufCheckCursor = glBufInUseList;
+
+    block_p = glBufCheckCursor;
+    while ((block_p != 0) && (count < maxBlocks))
+    {
+        if (CyU3PDmaBufFindRegion ((uint32_t)block_p) == 0)
+        {
+            stat = CY_U3P_ERROR_FAILURE;
+            break;
+        }
+
+        count++;
+        mem_p = (uint32_t *)((uint8_t *)block_p + block_p->alloc_size - sizeof (uint32_t));
+        if ((block_p->start_sig != CY_U3P_MEM_START_SIG) || (*mem_p != CY_U3P_MEM_END_SIG))
+        {
+            bad_p = block_p;
+            stat  = CY_U3P_ERROR_FAILURE;
+            break;
+        }
+
+        block_p = block_p->prev_blk;
+    }
+
+    /* Once we find any corruption, we cannot rely on the list pointers any more. Start again
+       from the head of the list on the next call. */
+    glBufCheckCursor = (stat == CY_U3P_SUCCESS) ? block_p : 0;
+    CyU3PMutexPut (&glBufferManager.lock);
+
+    if ((bad_p != 0) && (glBufBadCb != 0))
+        glBufBadCb ((void *)((uint8_t *)bad_p + CY_U3P_BUF_HDR_SIZE));
+
+    if (checked_p != 0)
+        *checked_p = count;
+
+    return stat;
+}
+
 #endif
 
 /*[]*/
@@ -0,0 +1,129 @@
+/*
+ ## Cypress FX3 Firmware Header File (cyfxtx.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXTX_H_
+#define _INCLUDED_CYFXTX_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* This header file declares the functions provided by cyfxtx.c in addition to the
+ * allocator interface that is required by the FX3 SDK drivers. */
+
+/* Placement of time critical code and data in the tightly coupled memories of the ARM926EJ-S.
+ * Functions marked with CY_FX_ITCM_CODE are linked into the CYU3P_ITCM_SECTION input section,
+ * which the SDK linker script maps into the I-TCM along with the library interrupt handlers.
+ * Variables marked with CY_FX_DTCM_DATA are placed in the .cyfx_dtcm section; this is only
+ * moved into D-TCM when the application is built with CYFX_USE_DTCM=1 (see cyfxdtcm.ld).
+ * The .cyfx_dtcm section is not loaded from the firmware image, so these variables have to
+ * be initialized at runtime. The DMA engine cannot access the TCMs; DMA buffers and any
+ * data handed to the DMA engine must stay in system RAM. */
+#define CY_FX_ITCM_CODE         __attribute__ ((section ("CYU3P_ITCM_SECTION")))
+#define CY_FX_DTCM_DATA         __attribute__ ((section (".cyfx_dtcm")))
+
+/* When built with CYFXTX_MEM_FILL, CyU3PMemAlloc fills every driver heap block with this byte. It is
+ * the value ThreadX fills thread stacks with (TX_STACK_FILL), and all thread stacks are taken from
+ * the driver heap, so the part of a stack that has never been used still holds the pattern. The
+ * SDK drivers allocate their stacks like any other block, so the fill can not be limited to stacks. */
+#define CYFXTX_MEM_FILL_BYTE    (0xEF)
+#define CYFXTX_MEM_FILL_PATTERN (0xEFEFEFEFUL)
+
+/* Usage and fragmentation information for one of the heaps. */
+typedef struct CyFxHeapStats_t
+{
+    uint32_t totalSize;         /* Size of the heap in bytes. */
+    uint32_t usedSize;          /* Bytes currently allocated, including allocator overhead. */
+    uint32_t peakUsedSize;      /* Highest value of usedSize since the heap was created. */
+    uint32_t largestFree;       /* Largest block that can currently be allocated. */
+    uint32_t freeFragments;     /* Number of separate free blocks in the heap. */
+    uint32_t allocFailCount;    /* Number of allocation requests that failed. */
+} CyFxHeapStats_t;
+
+/* Information about one in-use heap block, taken from its MemBlockInfo header. */
+typedef struct CyFxBlockRecord_t
+{
+    uint32_t allocId;           /* Sequence number of the allocation. */
+    uint32_t allocSize;         /* Size of the block including the check header and footer. */
+    uint32_t address;           /* Address of the block header. */
+} CyFxBlockRecord_t;
+
+/* Get the total and unallocated size of the buffer heap, and the number of regions in it. */
+extern void
+CyU3PBufGetCapacity (
+        uint32_t *totalSize_p,
+        uint32_t *freeSize_p,
+        uint32_t *numRegions_p);
+
+/* Get the RAM area reserved for the 2-stage boot-loader. Returns NULL if the area has been
+ * given to the buffer heap (CYFXTX_RECLAIM_BOOT_AREA). */
+extern void *
+CyU3PBootAreaGet (
+        uint32_t *size_p);
+
+/* Get usage and fragmentation information for the driver heap (CyU3PMemAlloc). */
+extern void
+CyU3PMemGetStats (
+        CyFxHeapStats_t *stats_p);
+
+/* Get usage and fragmentation information for the buffer heap (CyU3PDmaBufferAlloc). */
+extern void
+CyU3PBufGetStats (
+        CyFxHeapStats_t *stats_p);
+
+/* Check up to maxBlocks in-use driver heap blocks for corruption, continuing from the
+ * previous call. Only available when memory error detection is supported by the SDK. */
+extern CyU3PReturnStatus_t
+CyU3PMemCorruptionCheckStep (
+        uint32_t  maxBlocks,
+        uint32_t *checked_p);
+
+/* Check up to maxBlocks in-use buffer heap blocks for corruption, continuing from the
+ * previous call. Thread context only; returns CY_U3P_ERROR_TIMEOUT without checking any
+ * block while an allocation holds the buffer heap lock. Only available when memory error
+ * detection is supported by the SDK. */
+extern CyU3PReturnStatus_t
+CyU3PBufCorruptionCheckStep (
+        uint32_t  maxBlocks,
+        uint32_t *checked_p);
+
+/* Copy information about in-use driver heap blocks, newest first. Only available when
+ * memory error detection is supported by the SDK. */
+extern uint32_t
+CyU3PMemGetInUseBlocks (
+        CyFxBlockRecord_t *rec_p,
+        uint32_t           skip,
+        uint32_t           maxCount);
+
+/* Copy information about in-use buffer heap blocks, newest first. Only available when
+ * memory error detection is supported by the SDK. */
+extern uint32_t
+CyU3PBufGetInUseBlocks (
+        CyFxBlockRecord_t *rec_p,
+        uint32_t           skip,
+        uint32_t           maxCount);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXTX_H_ */
+
+/*[]*/
+
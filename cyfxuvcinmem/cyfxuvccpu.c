@@ -0,0 +1,229 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvccpu.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the CPU load accounting of the UVC application (see cyfxuvccpu.h). The
+ * idle thread is the only writer of the accounting data. It adds each step of its loop to the
+ * slot being filled; the slots that have been completed are only read, by CyFxUVCCpuGetLoad.
+ * Moving on to the next slot and reading the completed slots are done with interrupts disabled.
+ * One more slot than the window length is kept, so that the window always covers
+ * CY_FX_UVC_CPU_SLOTS completed slots once it has filled up. */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyfxuvccpu.h"
+#include "cyfxuvctime.h"
+
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+
+#define CY_FX_UVC_CPU_SLOT_COUNT        (CY_FX_UVC_CPU_SLOTS + 1)
+
+/* Time accounted to one thread. */
+typedef struct CyFxUVCCpuEntry_t
+{
+    CyU3PThread *thread_p;                              /* Thread accounted for by this entry. */
+    uint32_t     runCount;                              /* ThreadX run count of the thread at the last step. */
+    uint32_t     ran;                                   /* Whether the thread was scheduled during the last step. */
+    uint32_t     slotUs[CY_FX_UVC_CPU_SLOT_COUNT];      /* Time taken by the thread in each slot. */
+} CyFxUVCCpuEntry_t;
+
+static CyU3PThread       glCpuThread;                                   /* Idle thread. */
+static CyFxUVCCpuEntry_t glCpuEntry[CY_FX_UVC_CPU_MAX_THREADS];         /* Accounting of the other threads. */
+static uint32_t          glCpuEntryCount = 0;                           /* Number of entries in use. */
+static uint32_t          glCpuIdleUs[CY_FX_UVC_CPU_SLOT_COUNT];         /* Idle time in each slot. */
+static uint32_t          glCpuIsrUs[CY_FX_UVC_CPU_SLOT_COUNT];          /* Time taken with no thread scheduled. */
+static uint32_t          glCpuSlotLenUs[CY_FX_UVC_CPU_SLOT_COUNT];      /* Length of each completed slot. */
+static uint32_t          glCpuSlot = 0;                                 /* Slot being filled. */
+static uint32_t          glCpuSlotStart;                                /* Time (us) at which the slot started. */
+
+/* Give a step of the idle loop that was taken by the rest of the system to the threads that were
+ * scheduled during the step. Threads that are not in the list yet, or that replace an entry, are
+ * taken into account from the next step on. Threads beyond CY_FX_UVC_CPU_MAX_THREADS are not
+ * tracked, and their time is counted as interrupt time. */
+static void
+CyFxUVCCpuCharge (
+        uint32_t elapsed)
+{
+    CyFxUVCCpuEntry_t *entry_p;
+    CyU3PThread *thread_p;
+    uint32_t count = 0, first = 0, share, posture, i = 0;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    for (thread_p = glCpuThread.tx_thread_created_next;
+            (thread_p != &glCpuThread) && (thread_p != NULL) && (i < CY_FX_UVC_CPU_MAX_THREADS);
+            thread_p = thread_p->tx_thread_created_next, i++)
+    {
+        entry_p = &glCpuEntry[i];
+        if (entry_p->thread_p != thread_p)
+        {
+            CyU3PMemSet ((uint8_t *)entry_p, 0, sizeof (CyFxUVCCpuEntry_t));
+            entry_p->thread_p = thread_p;
+            entry_p->runCount = thread_p->tx_thread_run_count;
+            continue;
+        }
+
+        entry_p->ran      = (thread_p->tx_thread_run_count != entry_p->runCount);
+        entry_p->runCount = thread_p->tx_thread_run_count;
+        if (entry_p->ran)
+        {
+            if (count++ == 0)
+                first = i;
+        }
+    }
+    glCpuEntryCount = i;
+    tx_interrupt_control (posture);
+
+    if (count == 0)
+    {
+        glCpuIsrUs[glCpuSlot] += elapsed;
+        return;
+    }
+
+    share = elapsed / count;
+    for (i = 0; i < glCpuEntryCount; i++)
+    {
+        if (glCpuEntry[i].ran)
+            glCpuEntry[i].slotUs[glCpuSlot] += share;
+    }
+    glCpuEntry[first].slotUs[glCpuSlot] += elapsed - (share * count);
+}
+
+/* Complete the current slot and start the next one. */
+static void
+CyFxUVCCpuNextSlot (
+        uint32_t now)
+{
+    uint32_t posture, i;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    glCpuSlotLenUs[glCpuSlot] = now - glCpuSlotStart;
+    glCpuSlot = (glCpuSlot + 1) % CY_FX_UVC_CPU_SLOT_COUNT;
+    glCpuSlotLenUs[glCpuSlot] = 0;
+    glCpuIdleUs[glCpuSlot]    = 0;
+    glCpuIsrUs[glCpuSlot]     = 0;
+    for (i = 0; i < CY_FX_UVC_CPU_MAX_THREADS; i++)
+        glCpuEntry[i].slotUs[glCpuSlot] = 0;
+    tx_interrupt_control (posture);
+
+    glCpuSlotStart = now;
+}
+
+static void
+CyFxUVCCpuThread_Entry (
+        uint32_t input)
+{
+    uint32_t now, last, step;
+
+    /* Register the threads that exist so far. */
+    CyFxUVCCpuCharge (0);
+
+    last = CyFxUVCTimeUs ();
+    glCpuSlotStart = last;
+    for (;;)
+    {
+        now  = CyFxUVCTimeUs ();
+        step = now - last;
+        last = now;
+
+        if (step <= CY_FX_UVC_CPU_GAP_US)
+            glCpuIdleUs[glCpuSlot] += step;
+        else
+            CyFxUVCCpuCharge (step);
+
+        if ((now - glCpuSlotStart) >= (CY_FX_UVC_CPU_SLOT_MS * 1000))
+            CyFxUVCCpuNextSlot (now);
+    }
+}
+
+CyU3PReturnStatus_t
+CyFxUVCCpuInit (
+        void)
+{
+    void *ptr;
+
+    ptr = CyU3PMemAlloc (CY_FX_UVC_CPU_THREAD_STACK);
+    if (ptr == NULL)
+    {
+        return CY_U3P_ERROR_MEMORY_ERROR;
+    }
+
+    return CyU3PThreadCreate (&glCpuThread,             /* Idle thread structure */
+            "32:UVC_idle_thread",                       /* Thread Id and name */
+            CyFxUVCCpuThread_Entry,                     /* Idle thread entry function */
+            0,                                          /* No input parameter to thread */
+            ptr,                                        /* Pointer to the allocated thread stack */
+            CY_FX_UVC_CPU_THREAD_STACK,                 /* Idle thread stack size */
+            CY_FX_UVC_CPU_THREAD_PRIORITY,              /* Idle thread priority */
+            CY_FX_UVC_CPU_THREAD_PRIORITY,              /* Pre-emption threshold */
+            CYU3P_NO_TIME_SLICE,                        /* No time slice for the idle thread */
+            CYU3P_AUTO_START                            /* Start the thread immediately */
+            );
+}
+
+void
+CyFxUVCCpuGetLoad (
+        CyFxUVCCpuLoad_t *load_p)
+{
+    uint32_t busyUs[CY_FX_UVC_CPU_MAX_THREADS];
+    uint32_t idleUs = 0, isrUs = 0, total, posture, count, slot, i, j;
+    const char *name_p;
+
+    CyU3PMemSet ((uint8_t *)load_p, 0, sizeof (CyFxUVCCpuLoad_t));
+    CyU3PMemSet ((uint8_t *)busyUs, 0, sizeof (busyUs));
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    count = glCpuEntryCount;
+    for (slot = 0; slot < CY_FX_UVC_CPU_SLOT_COUNT; slot++)
+    {
+        if (slot == glCpuSlot)
+            continue;
+        load_p->windowUs += glCpuSlotLenUs[slot];
+        idleUs += glCpuIdleUs[slot];
+        isrUs  += glCpuIsrUs[slot];
+        for (i = 0; i < count; i++)
+            busyUs[i] += glCpuEntry[i].slotUs[slot];
+    }
+    tx_interrupt_control (posture);
+
+    /* The shares are taken of the time accounted for, so that they add up to 1000. */
+    total = idleUs + isrUs;
+    for (i = 0; i < count; i++)
+        total += busyUs[i];
+    if (total == 0)
+        return;
+
+    load_p->idlePermille = (uint32_t)(((uint64_t)idleUs * 1000) / total);
+    load_p->isrPermille  = (uint32_t)(((uint64_t)isrUs * 1000) / total);
+    load_p->threadCount  = count;
+    for (i = 0; i < count; i++)
+    {
+        load_p->thread[i].permille = (uint32_t)(((uint64_t)busyUs[i] * 1000) / total);
+        name_p = glCpuEntry[i].thread_p->tx_thread_name;
+        for (j = 0; (name_p != NULL) && (name_p[j] != 0) && (j < CY_FX_UVC_CPU_NAME_SIZE - 1); j++)
+            load_p->thread[i].name[j] = name_p[j];
+    }
+}
+
+#endif
+
+/*[]*/
+
@@ -0,0 +1,80 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvccpu.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCCPU_H_
+#define _INCLUDED_CYFXUVCCPU_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* CPU load accounting (make CYFX_CPU_LOAD=1). A thread at the lowest priority reads the
+ * microsecond time in a loop. Steps of up to CY_FX_UVC_CPU_GAP_US count as idle time; longer
+ * steps are time taken by the rest of the system, which is given to the threads that were
+ * scheduled in the meantime (their ThreadX run count changed), or to interrupts if no thread was.
+ * The ThreadX library of the SDK is not built with execution profiling, so this is the closest
+ * per-thread breakdown available. The times are kept for each slot of a sliding window. */
+#ifndef CY_FX_UVC_CPU_LOAD_ENABLE
+#define CY_FX_UVC_CPU_LOAD_ENABLE       (0)
+#endif
+
+#define CY_FX_UVC_CPU_GAP_US            (3)             /* Longest step of the idle loop counted as idle */
+#define CY_FX_UVC_CPU_SLOT_MS           (100)           /* Length of one window slot in ms */
+#define CY_FX_UVC_CPU_SLOTS             (10)            /* Slots in the sliding window */
+#define CY_FX_UVC_CPU_MAX_THREADS       (16)            /* Threads accounted for separately */
+#define CY_FX_UVC_CPU_NAME_SIZE         (20)            /* Bytes of the thread name reported */
+#define CY_FX_UVC_CPU_THREAD_STACK      (0x200)         /* Idle thread stack size */
+#define CY_FX_UVC_CPU_THREAD_PRIORITY   (31)            /* Idle thread priority, the lowest ThreadX priority */
+
+/* Share of the window taken by one thread. */
+typedef struct CyFxUVCCpuThreadLoad_t
+{
+    char     name[CY_FX_UVC_CPU_NAME_SIZE];     /* Start of the thread name, NUL terminated. */
+    uint32_t permille;                          /* Share of the window in units of 0.1 %. */
+} CyFxUVCCpuThreadLoad_t;
+
+/* CPU load over the completed slots of the sliding window, read by the
+ * CY_FX_RQT_GET_CPU_LOAD request. The shares add up to 1000 up to rounding. */
+typedef struct CyFxUVCCpuLoad_t
+{
+    uint32_t windowUs;                                  /* Length of the window in us. */
+    uint32_t idlePermille;                              /* Idle share of the window. */
+    uint32_t isrPermille;                               /* Share taken while no thread was scheduled. */
+    uint32_t threadCount;                               /* Number of valid thread entries. */
+    CyFxUVCCpuThreadLoad_t thread[CY_FX_UVC_CPU_MAX_THREADS];
+} CyFxUVCCpuLoad_t;
+
+/* Create the idle thread. Called once the microsecond time base is running. */
+extern CyU3PReturnStatus_t
+CyFxUVCCpuInit (
+        void);
+
+/* Compute the load over the completed slots of the window. */
+extern void
+CyFxUVCCpuGetLoad (
+        CyFxUVCCpuLoad_t *load_p);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCCPU_H_ */
+
+/*[]*/
+
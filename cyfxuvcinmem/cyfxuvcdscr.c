@@ -86,8 +86,8 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) =
     /* Configuration descriptor */
     0x09,                           /* Descriptor size */
     CY_U3P_USB_CONFIG_DESCR,        /* Configuration descriptor type */
-    0xC7,0x00,                      /* Length of this descriptor and all sub descriptors */
-    0x02,                           /* Number of interfaces */
+    0xD7,0x00,                      /* Length of this descriptor and all sub descriptors */
+    0x03,                           /* Number of interfaces */
     0x01,                           /* Configuration number */
     0x00,                           /* COnfiguration string index */
     0x80,                           /* Config characteristics - bus powered */
@@ -120,7 +120,7 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) =
     0x01,                           /* Descriptor sub type : VC_HEADER */
     0x10,0x01,                      /* Revision of class spec : 1.1 */
     0x51,0x00,                      /* Total size of class specific descriptors (till output terminal) */
-    0x00,0x6C,0xDC,0x02,            /* Clock frequency : 48MHz */
+    0x40,0x42,0x0F,0x00,            /* Clock frequency : 1MHz, the PTS and SCR time base */
     0x01,                           /* Number of streaming interfaces */
     0x01,                           /* Video streaming I/f 1 belongs to VC i/f */
 
@@ -262,7 +262,27 @@ const uint8_t CyFxUSBHSConfigDscr[] __attribute__ ((aligned (32))) =
     CY_U3P_USB_EP_ISO | 0x04,       /* ISO end point : Async */
     CY_FX_EP_ISO_VIDEO_PKT_SIZE_L,  /* 1 transaction per microframe */
     CY_FX_EP_ISO_VIDEO_PKT_SIZE_H,  /* CY_FX_EP_ISO_VIDEO_PKT_SIZE max bytes */
-    0x01                            /* Servicing interval for data transfers */
+    0x01,                           /* Servicing interval for data transfers */
+
+    /* Vendor specific telemetry interface descriptor. The interface is outside the video function
+     * (interface association above), so the UVC driver of the host does not bind to it. */
+    0x09,                           /* Descriptor size */
+    CY_U3P_USB_INTRFC_DESCR,        /* Interface descriptor type */
+    CY_FX_UVC_INTERFACE_TELEMETRY,  /* Interface number */
+    0x00,                           /* Alternate setting number */
+    0x01,                           /* Number of end points */
+    0xFF,                           /* Interface class : vendor specific */
+    0x00,                           /* Interface sub class */
+    0x00,                           /* Interface protocol code */
+    0x00,                           /* Interface descriptor string index */
+
+    /* Telemetry interrupt endpoint descriptor */
+    0x07,                           /* Descriptor size */
+    CY_U3P_USB_ENDPNT_DESCR,        /* Endpoint descriptor type */
+    CY_FX_EP_TELEMETRY,             /* Endpoint address and description */
+    CY_U3P_USB_EP_INTR,             /* Interrupt end point type */
+    0x40,0x00,                      /* Max packet size = 64 bytes */
+    0x08                            /* Servicing interval : 2^(8-1) x 125us = 16ms */
 };
 
 /* Standard full speed configuration descriptor : full speed is not supported. */
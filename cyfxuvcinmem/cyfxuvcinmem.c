@@ -44,8 +44,10 @@
    indexed video frame is chosen for transfer. When all the frames are transferred, the index is reset
    to start transfer from the first video frame.
 
-   CY_FX_UVC_STREAM_BUF_SIZE and CY_FX_UVC_STREAM_BUF_COUNT in the header file define the DMA buffer
-   size and the number of DMA buffers respectively.
+   The DMA buffer size and count are worked out when the stream is started. Each buffer holds the
+   data for one ISO service interval at the negotiated speed, burst and MULT settings. The number of
+   buffers is limited by CY_FX_UVC_STREAM_BUF_COUNT / CY_FX_UVC_SS_STREAM_BUF_COUNT and by the free
+   space in the buffer heap.
 
    This example is not supported on full speed interface.
 
@@ -63,6 +65,13 @@
 #include "cyu3dma.h"
 #include "cyu3error.h"
 #include "cyfxuvcinmem.h"
+#include "cyfxuvctrace.h"
+#include "cyfxuvclog.h"
+#include "cyfxuvctime.h"
+#include "cyfxuvccpu.h"
+#include "cyfxuvcprof.h"
+#include "cyfxuvcstack.h"
+#include "cyfxuvcstatus.h"
 #include "cyu3usb.h"
 #include "cyu3uart.h"
 #include "cyu3utils.h"
@@ -84,10 +93,10 @@
 
 CyU3PEpConfig_t uvcVideoEpCfg;
 CyU3PThread uvcAppThread;                                       /* Thread structure */
-static volatile uint8_t CurrentMultVal = 1;                     /* MULT value programmed into the EPM. */
+static volatile uint8_t CurrentMultVal CY_FX_DTCM_DATA;       /* MULT value programmed into the EPM. */
 
-/* UVC Header */
-uint8_t glUVCHeader[CY_FX_UVC_MAX_HEADER] =
+/* UVC Header template. Copied into glUVCHeader when the application is initialized. */
+static const uint8_t glUVCHeaderDefault[CY_FX_UVC_MAX_HEADER] =
 {
     0x0C,                           /* Header Length */
     0x8C,                           /* Bit field header field */
@@ -95,13 +104,100 @@ uint8_t glUVCHeader[CY_FX_UVC_MAX_HEADER] =
     0x00,0x00,0x00,0x00,0x00,0x00   /* Source clock reference field */
 };
 
+/* Length and BFH of the UVC header for each header format. */
+static const uint8_t glUVCHeaderLen[CY_FX_UVC_HEADER_FMT_COUNT] = { 2, 6, CY_FX_UVC_MAX_HEADER };
+static const uint8_t glUVCHeaderBfh[CY_FX_UVC_HEADER_FMT_COUNT] = { 0x80, 0x84, CY_FX_UVC_HEADER_DEFAULT_BFH };
+
+/* UVC Header */
+uint8_t glUVCHeader[CY_FX_UVC_MAX_HEADER] CY_FX_DTCM_DATA;
+
+/* Header format selected by the host, taken over for the stream at the next commit. */
+static volatile uint8_t glHeaderFormatReq = CY_FX_UVC_HEADER_FORMAT;
+
 /* Video Probe Commit Control */
 uint8_t glCommitCtrl[CY_FX_UVC_MAX_PROBE_SETTING_ALIGNED] __attribute__ ((aligned (32)));
 
+/* Data buffer used for the vendor specific diagnostic requests. */
+uint8_t glEp0Buffer[CY_FX_EP0_BUFFER_SIZE] __attribute__ ((aligned (32)));
+
 CyU3PDmaChannel          glChHandleUVCStream;           /* DMA Channel Handle  */
-static volatile CyBool_t glIsApplnActive = CyFalse;     /* Whether the UVC application is active or not. */
+static CyFxUVCStreamState_t glStreamState CY_FX_DTCM_DATA;    /* Video stream state. */
 static volatile CyBool_t glIsDevConfigured = CyFalse;   /* Whether the device has been configured. */
 
+/* State of the video stream (CY_FX_UVC_STREAM_*). Only changed by the UVC application thread. */
+static volatile uint8_t glStreamMode = CY_FX_UVC_STREAM_IDLE;
+
+/* Queue of the messages posted by the USB callbacks to the UVC application thread. */
+static CyU3PQueue glAppQueue;
+static uint32_t   glAppQueueBuf[CY_FX_UVC_MSG_QUEUE_LEN * sizeof (CyFxUVCAppMsg_t) / sizeof (uint32_t)];
+
+/* Stop or release message that did not fit in the application queue. It is handled after the
+ * glPendingMsgSeq messages queued before it, and merges the messages posted while it waits. */
+static CyFxUVCAppMsg_t   glPendingMsg;                  /* type is 0 when no message is pending. */
+static uint32_t          glPendingMsgSeq;               /* glMsgQueued when the message was posted. */
+static volatile uint32_t glMsgQueued;                   /* Messages queued. Only changed by the USB callbacks. */
+static uint32_t          glMsgReceived;                 /* Messages taken from the queue by the thread. */
+static CyFxUVCTransition_t glStreamTransition;          /* Stream start and stop times. */
+static CyFxUVCStreamStats_t glStreamStats;              /* Streaming statistics read by the host. */
+static CyFxUVCHistogram_t glStageHist[CY_FX_UVC_STAGE_COUNT];   /* Per-stage latency histograms. */
+
+#if CY_FX_UVC_PROFILE_ENABLE
+static CyFxUVCProfile_t glStreamProfile;                /* CPU time used by the video streamer. */
+
+/* Account one buffer, filled and committed between the times start and end (us). */
+#define CY_FX_UVC_PROFILE_BUFFER(start,end)     \
+    (glStreamProfile.busyUs += (end) - (start), glStreamProfile.bufCount++)
+#else
+#define CY_FX_UVC_PROFILE_BUFFER(start,end)
+#endif
+
+static CyFxUVCLatency_t glStreamLatency;                /* Consumer event to commit latency. */
+
+static CyU3PEvent glStreamEvent;                        /* Wakes the UVC application thread. */
+#if (!CY_FX_UVC_PRODUCER_CALLBACK)
+static uint32_t   glStreamWakeups;                      /* Number of times the video streamer blocked. */
+#endif
+static uint32_t glEventTimes[CY_FX_UVC_EVENT_RING_SIZE]; /* Times of the pending consumer events. */
+
+/* Number of ISO underruns of the video endpoint while streaming. Only incremented by the endpoint
+ * event callback; the DMA consumer callback matches the new ones with the payload just consumed. */
+static volatile uint32_t glUnderrunCount = 0;
+
+/* Whether each payload in flight ends a frame, indexed by the commit order of the payloads. */
+static uint8_t glPayloadEof[CY_FX_UVC_EVENT_RING_SIZE];
+
+/* bStreamErrorCode returned for VS_STREAM_ERROR_CODE_CONTROL, cleared when the host reads it. */
+static volatile uint8_t glStreamErrorCode = CY_FX_UVC_STREAM_ERR_NONE;
+
+/* Periodic telemetry record sent on the telemetry interface endpoint. The counts of a record are
+ * the change of the streaming statistics since glTelemetryLast, taken for the previous record. */
+static CyU3PTimer           glTelemetryTimer;
+static volatile CyBool_t    glTelemetryReady = CyFalse; /* Whether glTelemetryTimer has been created. */
+static uint32_t             glTelemetrySequence = 0;
+static uint32_t             glTelemetryTime;            /* Time (us) at which the previous record was built. */
+static CyFxUVCStreamStats_t glTelemetryLast;            /* Statistics when the previous record was built. */
+
+#if CY_FX_UVC_PRODUCER_CALLBACK
+static CyFxUVCPayload_t glPayloadPlan[CY_FX_UVC_MAX_PAYLOADS];  /* Payloads of one pass over the clip. */
+
+#endif
+
+static CY_FX_ITCM_CODE CyU3PReturnStatus_t
+CyFxUVCApplnFillBuffers (
+        uint32_t maxCount,
+        uint32_t now);
+
+static CyU3PReturnStatus_t
+CyFxUVCApplnPrefill (
+        void);
+
+static CyFxUVCBootProfile_t glBootProfile;              /* Start-up stage times. Cleared with .bss. */
+
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+static CyU3PTimer             glMemCheckTimer;          /* Timer used to run the background memory checks. */
+static CyFxUVCMemCheckStats_t glMemCheckStats;          /* Results of the background memory checks. */
+#endif
+
 /* Application error handler */
 void
 CyFxAppErrorHandler (
@@ -120,14 +216,27 @@ CyFxAppErrorHandler (
     }
 }
 
+/* Record the time at which a start-up stage is first reached. */
+static void
+CyFxUVCApplnBootMark (
+        uint8_t stage)
+{
+    if ((glBootProfile.stageMask & (1 << stage)) == 0)
+    {
+        glBootProfile.stageTick[stage] = CyU3PGetTime ();
+        glBootProfile.stageMask |= (1 << stage);
+    }
+}
+
 /* Set the MULT value for an ISO endpoint based on the EPM state. */
-void
+CY_FX_ITCM_CODE void
 CyFxUvcAppSetMultByEpm (
         uint8_t ep)
 {
     uint32_t val1 = *((uvint32_t *)(FX3_USB2_INEP_CFG_ADDR_BASE + (4 * ep)));
     uint32_t val2 = *((uvint32_t *)(FX3_USB2_INEP_EPM_ADDR_BASE + (4 * ep)));
     uint8_t  multVal = 0;
+    uint8_t  oldMult = (uint8_t)((val1 & FX3_USB2_INEP_MULT_MASK) >> FX3_USB2_INEP_MULT_POS);
 
     /* If the EPM is ready, find out how much data is present and then update the MULT setting. */
     if ((val2 & FX3_USB2_INEP_EPM_READY_MASK) != 0)
@@ -141,6 +250,8 @@ CyFxUvcAppSetMultByEpm (
     /* Adjust multVal to a value between 1 and 3. */
     multVal = CY_U3P_MIN (multVal, 3);
     multVal = CY_U3P_MAX (multVal, 1);
+    if (multVal != oldMult)
+        glStreamStats.multChangeCount++;
 
     val1 = (val1 & ~FX3_USB2_INEP_MULT_MASK) | (multVal << FX3_USB2_INEP_MULT_POS);
     *((uvint32_t *)(FX3_USB2_INEP_CFG_ADDR_BASE + (4 * ep))) = val1;
@@ -194,31 +305,291 @@ CyFxUVCApplnDebugInit (void)
     CyU3PDebugPreamble (CyFalse);
 }
 
-/* This callback is used to track whether the channel has committed any data to the endpoint. */
-void CyFxUVCAppDmaCallback (
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+
+/* Callback from the allocators when a corrupted memory block is found. This can be called
+ * from any context, and only records the block. */
+static void
+CyFxUVCApplnMemCorruptCb (
+        void *mem_p)
+{
+    glMemCheckStats.badBlockCount++;
+    glMemCheckStats.lastBadBlock = (uint32_t)mem_p;
+}
+
+/* Timer callback that starts a memory check run. The buffer heap check takes a mutex, which is
+ * not allowed in timer context, so the run is left to the UVC application thread. */
+static void
+CyFxUVCApplnMemCheckTimerCb (
+        uint32_t input)
+{
+    CyU3PEventSet (&glStreamEvent, CY_FX_UVC_STREAM_EVT_MEM_CHECK, CYU3P_EVENT_OR);
+}
+
+/* Verify a bounded number of in-use blocks in both heaps. Called by the UVC application thread. */
+static void
+CyFxUVCApplnMemCheck (
+        void)
+{
+    uint32_t count = 0;
+    CyU3PReturnStatus_t status;
+
+    glMemCheckStats.runCount++;
+
+    if (CyU3PMemCorruptionCheckStep (CY_FX_UVC_MEM_CHECK_BLOCKS, &count) != CY_U3P_SUCCESS)
+        glMemCheckStats.checkFailCount++;
+    glMemCheckStats.memBlocksChecked += count;
+
+    /* The buffer heap is skipped while an allocation holds its lock. */
+    status = CyU3PBufCorruptionCheckStep (CY_FX_UVC_MEM_CHECK_BLOCKS, &count);
+    if (status == CY_U3P_ERROR_TIMEOUT)
+        glMemCheckStats.bufCheckSkipCount++;
+    else if (status != CY_U3P_SUCCESS)
+        glMemCheckStats.checkFailCount++;
+    glMemCheckStats.bufBlocksChecked += count;
+}
+
+#endif
+
+/* Histogram bucket of a latency sample: the number of significant bits, limited to the last bucket. */
+static CY_FX_ITCM_CODE uint32_t
+CyFxUVCApplnHistBucket (
+        uint32_t value)         /* Sample in us */
+{
+    uint32_t bucket = 0;
+
+    while (((value >> bucket) != 0) && (bucket < (CY_FX_UVC_HIST_BUCKETS - 1)))
+        bucket++;
+
+    return bucket;
+}
+
+/* Add a sample to the latency histogram of a pipeline stage. Called with interrupts disabled. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnHistUpdate (
+        uint32_t stage,         /* Pipeline stage: CY_FX_UVC_STAGE_* */
+        uint32_t value,         /* Sample in us */
+        uint32_t bucket)        /* CyFxUVCApplnHistBucket (value) */
+{
+    CyFxUVCHistogram_t *hist_p = &glStageHist[stage];
+
+    hist_p->bucket[bucket]++;
+    hist_p->sampleCount++;
+    hist_p->totalUs += value;
+    if (value > hist_p->maxUs)
+        hist_p->maxUs = value;
+}
+
+/* Add a sample to the latency histogram of a pipeline stage. The samples come from the application
+ * thread and the DMA callback, so the histogram is updated with interrupts disabled. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnHistAdd (
+        uint32_t stage,         /* Pipeline stage: CY_FX_UVC_STAGE_* */
+        uint32_t value)         /* Sample in us */
+{
+    uint32_t bucket = CyFxUVCApplnHistBucket (value);
+    uint32_t posture;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    CyFxUVCApplnHistUpdate (stage, value, bucket);
+    tx_interrupt_control (posture);
+}
+
+/* Add the buffer wait, fill and commit samples of one stream buffer to their histograms, with
+ * interrupts disabled once for all three. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnHistAddBuffer (
+        uint32_t waitUs,        /* CY_FX_UVC_STAGE_BUF_WAIT sample */
+        uint32_t fillUs,        /* CY_FX_UVC_STAGE_FILL sample */
+        uint32_t commitUs)      /* CY_FX_UVC_STAGE_COMMIT sample */
+{
+    uint32_t waitBucket   = CyFxUVCApplnHistBucket (waitUs);
+    uint32_t fillBucket   = CyFxUVCApplnHistBucket (fillUs);
+    uint32_t commitBucket = CyFxUVCApplnHistBucket (commitUs);
+    uint32_t posture;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    CyFxUVCApplnHistUpdate (CY_FX_UVC_STAGE_BUF_WAIT, waitUs, waitBucket);
+    CyFxUVCApplnHistUpdate (CY_FX_UVC_STAGE_FILL, fillUs, fillBucket);
+    CyFxUVCApplnHistUpdate (CY_FX_UVC_STAGE_COMMIT, commitUs, commitBucket);
+    tx_interrupt_control (posture);
+}
+
+/* Match the endpoint underruns since the previous consumer event with the payload just consumed: the
+ * endpoint ran dry while it waited for this payload, so the gap is in the frame of this payload. If
+ * the producer has not filled the end of that frame yet, it sets the error bit in the next payload
+ * of the frame. Called from the DMA consumer callback for each payload in commit order. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnCountUnderruns (
+        uint32_t payload)       /* Index of the consumed payload in the stream */
+{
+    uint32_t underruns = glUnderrunCount - glStreamState.underrunSeen;
+    uint32_t posture;
+
+    if (underruns != 0)
+    {
+        glStreamState.underrunSeen   += underruns;
+        glStreamState.frameUnderruns += underruns;
+        glStreamErrorCode = CY_FX_UVC_STREAM_ERR_UNDERRUN;
+
+        posture = tx_interrupt_control (TX_INT_DISABLE);
+        if (glStreamState.fillFrame == glStreamState.wireFrame)
+            glStreamState.errFrame = glStreamState.wireFrame + 1;
+        else
+            glStreamStats.underrunUnmarked += underruns;
+        tx_interrupt_control (posture);
+    }
+
+    if (glPayloadEof[payload & (CY_FX_UVC_EVENT_RING_SIZE - 1)])
+    {
+        /* Count the frame if an underrun happened while it was sent. */
+        if (glStreamState.frameUnderruns != 0)
+        {
+            glStreamState.underrunFrames++;
+            glStreamStats.underrunFrames++;
+            if (glStreamState.frameUnderruns > glStreamStats.underrunFrameMax)
+                glStreamStats.underrunFrameMax = glStreamState.frameUnderruns;
+            glStreamState.frameUnderruns = 0;
+        }
+        glStreamState.wireFrame++;
+    }
+}
+
+/* This callback is used to track whether the channel has committed any data to the endpoint. In the
+ * callback producer mode, it also refills the stream buffers. */
+CY_FX_ITCM_CODE void
+CyFxUVCAppDmaCallback (
         CyU3PDmaChannel   *handle,
         CyU3PDmaCbType_t   type,
         CyU3PDmaCBInput_t *input)
 {
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_DMA_CB, type, glStreamLatency.eventHead, 0);
+
     if (type == CY_U3P_DMA_CB_CONS_EVENT)
     {
+        /* Note the time at which the buffer was freed. The first buffer sent ends the stream start. */
+        glEventTimes[glStreamLatency.eventHead & (CY_FX_UVC_EVENT_RING_SIZE - 1)] = CyFxUVCTimeUs ();
+        if (glStreamLatency.eventHead == 0)
+            glStreamLatency.firstUs = glEventTimes[0] - glStreamLatency.startTime;
+        else
+            CyFxUVCApplnHistAdd (CY_FX_UVC_STAGE_EVENT,
+                    glEventTimes[glStreamLatency.eventHead & (CY_FX_UVC_EVENT_RING_SIZE - 1)] -
+                    glEventTimes[(glStreamLatency.eventHead - 1) & (CY_FX_UVC_EVENT_RING_SIZE - 1)]);
+        CyFxUVCApplnCountUnderruns (glStreamLatency.eventHead);
+        glStreamLatency.eventHead++;
+        glStreamStats.consEventCount++;
+
         if (CyU3PUsbGetSpeed () == CY_U3P_HIGH_SPEED)
         {
             /* Update the ISO MULT setting based on the number of data packets ready in the EPM. */
             CyFxUvcAppSetMultByEpm (CY_FX_EP_ISO_VIDEO & 0x0F);
         }
+
+#if CY_FX_UVC_PRODUCER_CALLBACK
+        /* Refill the free buffers right away. */
+        if (CyFxUVCApplnFillBuffers (glStreamState.bufCount,
+                    glEventTimes[(glStreamLatency.eventHead - 1) & (CY_FX_UVC_EVENT_RING_SIZE - 1)]) != CY_U3P_SUCCESS)
+        {
+            CY_FX_UVC_LOG (4, "UVC buffer commit failed\r\n");
+        }
+#else
+        /* Wake up the video streamer if it is waiting for a free buffer. */
+        CyU3PEventSet (&glStreamEvent, CY_FX_UVC_STREAM_EVT_BUF_FREE, CYU3P_EVENT_OR);
+#endif
     }
 }
 
-/* This function starts the video streaming application. It is called
- * when there is a SET_INTERFACE event for alternate interface 1. */
-CyU3PReturnStatus_t
-CyFxUVCApplnStart (void)
+/* Size of the stream DMA buffers at a connection speed. Each buffer carries one payload, which has
+ * to fit in one ISO service interval. */
+static uint32_t
+CyFxUVCApplnGetBufSize (
+        CyU3PUSBSpeed_t speed)
+{
+    if (speed == CY_U3P_SUPER_SPEED)
+    {
+        return (CY_FX_EP_ISO_VIDEO_PKT_SIZE * CY_FX_EP_ISO_VIDEO_SS_BURST * CY_FX_EP_ISO_VIDEO_SS_MULT);
+    }
+
+    /* The ISO MULT work-around expects a full buffer to fill all packets of a micro-frame. */
+    return CY_FX_UVC_STREAM_BUF_SIZE;
+}
+
+/* Work out the DMA buffer size and count for the stream. The buffer count is limited by the free
+ * space in the buffer heap. */
+static CyU3PReturnStatus_t
+CyFxUVCApplnSetBufGeometry (
+        CyU3PUSBSpeed_t speed)
+{
+    uint32_t size, maxCount, count;
+    uint32_t freeSize = 0;
+
+    size     = CyFxUVCApplnGetBufSize (speed);
+    maxCount = (speed == CY_U3P_SUPER_SPEED) ? CY_FX_UVC_SS_STREAM_BUF_COUNT : CY_FX_UVC_STREAM_BUF_COUNT;
+
+    CyU3PBufGetCapacity (0, &freeSize, 0);
+    freeSize = (freeSize > CY_FX_UVC_BUF_HEAP_RESERVE) ? (freeSize - CY_FX_UVC_BUF_HEAP_RESERVE) : 0;
+    count    = CY_U3P_MIN (maxCount, freeSize / (size + CY_FX_UVC_BUF_HEAP_OVERHEAD));
+
+    if (count < CY_FX_UVC_STREAM_BUF_COUNT_MIN)
+    {
+        CY_FX_UVC_LOG (4, "Buffer heap too small for stream: %d bytes free\r\n", freeSize);
+        return CY_U3P_ERROR_MEMORY_ERROR;
+    }
+
+    glStreamState.bufSize  = (uint16_t)size;
+    glStreamState.bufCount = (uint16_t)count;
+    return CY_U3P_SUCCESS;
+}
+
+#if CY_FX_UVC_PRODUCER_CALLBACK
+/* Work out the payloads for one pass over the video clip with the current buffer size and header
+ * length. Each frame is split into payloads of up to (bufSize - header) bytes, and the last one is
+ * marked as EOF. */
+static CyU3PReturnStatus_t
+CyFxUVCApplnBuildPlan (
+        void)
+{
+    uint32_t frame, offset, length;
+    uint32_t frameStart = 0, count = 0;
+    uint32_t maxLength = glStreamState.bufSize - glStreamState.headerLen;
+
+    for (frame = 0; frame < CY_FX_UVC_MAX_VID_FRAMES; frame++)
+    {
+        for (offset = 0; offset < glVidFrameLen[frame]; offset += length)
+        {
+            if (count == CY_FX_UVC_MAX_PAYLOADS)
+            {
+                CY_FX_UVC_LOG (4, "Payload plan does not fit in %d entries\r\n", CY_FX_UVC_MAX_PAYLOADS);
+                return CY_U3P_ERROR_MEMORY_ERROR;
+            }
+
+            length = CY_U3P_MIN (maxLength, glVidFrameLen[frame] - offset);
+            glPayloadPlan[count].offset = frameStart + offset;
+            glPayloadPlan[count].length = (uint16_t)length;
+            glPayloadPlan[count].isEof  = ((offset + length) == glVidFrameLen[frame]);
+            count++;
+        }
+
+        frameStart += glVidFrameLen[frame];
+    }
+
+    glStreamState.planCount = count;
+    glStreamState.planIndex = 0;
+    return CY_U3P_SUCCESS;
+}
+#endif
+
+/* Configure the video streaming endpoint and create the stream DMA channel with the buffer geometry
+ * for the current connection speed. The channel is kept across stream stops and restarts, and only
+ * released by CyFxUVCApplnRelease. */
+static CyU3PReturnStatus_t
+CyFxUVCApplnCreateChannel (
+        CyU3PUSBSpeed_t speed)
 {
     CyU3PDmaChannelConfig_t dmaCfg;
     CyU3PReturnStatus_t apiRetStatus = CY_U3P_SUCCESS;
 
-    if (CyU3PUsbGetSpeed () == CY_U3P_SUPER_SPEED)
+    if (speed == CY_U3P_SUPER_SPEED)
     {
         uvcVideoEpCfg.isoPkts  = CY_FX_EP_ISO_VIDEO_SS_MULT;
         uvcVideoEpCfg.burstLen = CY_FX_EP_ISO_VIDEO_SS_BURST;
@@ -230,6 +601,12 @@ CyFxUVCApplnStart (void)
         uvcVideoEpCfg.burstLen = 1;
     }
 
+    apiRetStatus = CyFxUVCApplnSetBufGeometry (speed);
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        return apiRetStatus;
+    }
+
     /* Video streaming endpoint configuration */
     uvcVideoEpCfg.enable    = CyTrue;
     uvcVideoEpCfg.epType    = CY_U3P_USB_EP_ISO;
@@ -239,14 +616,14 @@ CyFxUVCApplnStart (void)
     apiRetStatus = CyU3PSetEpConfig(CY_FX_EP_ISO_VIDEO, &uvcVideoEpCfg);
     if (apiRetStatus != CY_U3P_SUCCESS)
     {
-        CyU3PDebugPrint (4, "CyU3PSetEpConfig failed, Error Code = 0x%x\r\n", apiRetStatus);
+        CY_FX_UVC_LOG (4, "CyU3PSetEpConfig failed, Error Code = 0x%x\r\n", apiRetStatus);
         return apiRetStatus;
     }
 
     /* Create a DMA Manual OUT channel for streaming data */
     /* Video streaming Channel is not active till a stream request is received */
-    dmaCfg.size = CY_FX_UVC_STREAM_BUF_SIZE;
-    dmaCfg.count = CY_FX_UVC_STREAM_BUF_COUNT;
+    dmaCfg.size = glStreamState.bufSize;
+    dmaCfg.count = glStreamState.bufCount;
     dmaCfg.prodSckId = CY_U3P_CPU_SOCKET_PROD;
     dmaCfg.consSckId = CY_FX_EP_VIDEO_CONS_SOCKET;
     dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
@@ -257,51 +634,267 @@ CyFxUVCApplnStart (void)
     dmaCfg.consHeader = 0;
     dmaCfg.prodAvailCount = 0;
     apiRetStatus = CyU3PDmaChannelCreate (&glChHandleUVCStream, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaCfg);
+
+    /* The free space in the buffer heap may be fragmented. Retry with fewer buffers if the
+     * buffers could not be allocated. */
+    while ((apiRetStatus == CY_U3P_ERROR_MEMORY_ERROR) && (dmaCfg.count > CY_FX_UVC_STREAM_BUF_COUNT_MIN))
+    {
+        dmaCfg.count--;
+        apiRetStatus = CyU3PDmaChannelCreate (&glChHandleUVCStream, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaCfg);
+    }
+
     if (apiRetStatus != CY_U3P_SUCCESS)
     {
-        CyU3PDebugPrint (4, "CyU3PDmaChannelCreate failed, error code = %d\r\n",apiRetStatus);
+        CY_FX_UVC_LOG (4, "CyU3PDmaChannelCreate failed, error code = %d\r\n",apiRetStatus);
+        uvcVideoEpCfg.enable = CyFalse;
+        CyU3PSetEpConfig(CY_FX_EP_ISO_VIDEO, &uvcVideoEpCfg);
         return apiRetStatus;
     }
 
+    glStreamMode           = CY_FX_UVC_STREAM_READY;
+    glStreamState.bufCount = dmaCfg.count;
+    glStreamTransition.createCount++;
+    CY_FX_UVC_LOG (4, "Stream buffers: %d x %d bytes\r\n", glStreamState.bufCount, glStreamState.bufSize);
+    return CY_U3P_SUCCESS;
+}
+
+/* Destroy the stream DMA channel, freeing its buffers, and disable the video streaming endpoint. Called
+ * when the configuration is changed or lost, and when the stream needs a different buffer geometry. */
+static void
+CyFxUVCApplnRelease (
+        void)
+{
+    CyU3PDmaChannelDestroy (&glChHandleUVCStream);
+    glStreamMode = CY_FX_UVC_STREAM_IDLE;
+
     /* Flush the endpoint memory */
     CyU3PUsbFlushEp(CY_FX_EP_ISO_VIDEO);
 
+    /* Disable the video streaming endpoint. */
+    uvcVideoEpCfg.enable = CyFalse;
+    CyU3PSetEpConfig(CY_FX_EP_ISO_VIDEO, &uvcVideoEpCfg);
+    CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
+}
+
+/* Add the time since startTime to a transition time record. */
+static void
+CyFxUVCApplnTransitionDone (
+        uint32_t  startTime,
+        uint32_t *count_p,
+        uint32_t *totalUs_p,
+        uint32_t *maxUs_p)
+{
+    uint32_t elapsed = CyFxUVCTimeUs () - startTime;
+
+    (*count_p)++;
+    *totalUs_p += elapsed;
+    if (elapsed > *maxUs_p)
+        *maxUs_p = elapsed;
+}
+
+/* Number of payloads needed for one pass over the video clip with the current buffer size and
+ * header length. */
+static uint32_t
+CyFxUVCApplnClipPayloads (
+        void)
+{
+    uint32_t frame, count = 0;
+    uint32_t maxLength = glStreamState.bufSize - glStreamState.headerLen;
+
+    for (frame = 0; frame < CY_FX_UVC_MAX_VID_FRAMES; frame++)
+    {
+        count += (glVidFrameLen[frame] + maxLength - 1) / maxLength;
+    }
+
+    return count;
+}
+
+/* This function starts the video streaming application. It is called from the
+ * UVC application thread on a SET_INTERFACE request for alternate interface 1,
+ * with the stream channel created. */
+CyU3PReturnStatus_t
+CyFxUVCApplnStart (void)
+{
+    CyU3PReturnStatus_t apiRetStatus = CY_U3P_SUCCESS;
+
+    /* Start the latency measurement for this stream. */
+    glStreamLatency.eventHead   = 0;
+    glStreamLatency.eventTail   = 0;
+    glStreamLatency.commitCount = 0;
+
+    /* Set up the header in the committed format. */
+    glStreamState.headerLen = glUVCHeaderLen[glStreamState.headerFormat];
+    glUVCHeader[0] = glStreamState.headerLen;
+    glUVCHeader[1] = glUVCHeaderBfh[glStreamState.headerFormat];
+
+#if CY_FX_UVC_PRODUCER_CALLBACK
+    apiRetStatus = CyFxUVCApplnBuildPlan ();
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        return apiRetStatus;
+    }
+#endif
+
+    /* Start the video clip from the first frame. */
+    glStreamState.frameStart  = 0;
+    glStreamState.frameIndex  = 0;
+    glStreamState.frameOffset = 0;
+    glStreamState.planIndex   = 0;
+    glStreamState.ptsPending  = 1;
+    glStreamState.bufWaiting  = 0;
+
+    /* Underruns of a previous stream are not reported in this one. */
+    glStreamState.underrunSeen   = glUnderrunCount;
+    glStreamState.frameUnderruns = 0;
+    glStreamState.underrunFrames = 0;
+    glStreamState.payloadCount   = 0;
+    glStreamState.fillFrame      = 0;
+    glStreamState.wireFrame      = 0;
+    glStreamState.errFrame       = 0;
+    glStreamErrorCode = CY_FX_UVC_STREAM_ERR_NONE;
+    CY_FX_UVC_LOG (4, "Stream header: %d bytes, %d payloads per pass over the clip\r\n", glStreamState.headerLen,
+            CyFxUVCApplnClipPayloads ());
+
+    /* Flush the endpoint memory, and keep the endpoint NAKed until the first buffers are queued. */
+    CyU3PUsbFlushEp(CY_FX_EP_ISO_VIDEO);
+    CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyTrue);
+
     apiRetStatus = CyU3PDmaChannelSetXfer (&glChHandleUVCStream, 0);
     if (apiRetStatus != CY_U3P_SUCCESS)
     {
-        CyU3PDebugPrint (4, "CyU3PDmaChannelSetXfer failed, error code = %d\r\n", apiRetStatus);
+        CY_FX_UVC_LOG (4, "CyU3PDmaChannelSetXfer failed, error code = %d\r\n", apiRetStatus);
+        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
+        return apiRetStatus;
+    }
+
+    glStreamMode = CY_FX_UVC_STREAM_ACTIVE;
+
+    /* Queue the first payloads before the endpoint goes live. As no buffer is consumed until then, the
+     * consumer callback in the callback producer mode only starts refilling buffers after this. */
+    apiRetStatus = CyFxUVCApplnPrefill ();
+    if (CyU3PUsbGetSpeed () == CY_U3P_HIGH_SPEED)
+    {
+        CyFxUvcAppSetMultByEpm (CY_FX_EP_ISO_VIDEO & 0x0F);
+    }
+    CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
+
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CY_FX_UVC_LOG (4, "Stream prefill failed, error code = %d\r\n", apiRetStatus);
         return apiRetStatus;
     }
 
-    /* Update the flag so that the application thread is notified of this. */
-    glIsApplnActive = CyTrue;
-    CyU3PDebugPrint(3, "App Started\r\n");
+    CY_FX_UVC_LOG (3, "App Started\r\n");
     return CY_U3P_SUCCESS;
 }
 
-/* This function stops the video streaming. It is called from the USB event
- * handler, when there is a reset / disconnect or SET_INTERFACE for alternate
- * interface 0. */
+/* This function stops the video streaming. It is called from the UVC
+ * application thread, when there is a reset / disconnect or SET_INTERFACE for
+ * alternate interface 0. The stream channel and the endpoint configuration are
+ * kept for the next start: the channel is reset, which returns all buffers to
+ * the producer, and the endpoint is NAKed and flushed. */
 void
 CyFxUVCApplnStop (void)
 {
-    /* Update the flag so that the application thread is notified of this. */
-    glIsApplnActive = CyFalse;
-
-    /* Abort and destroy the video streaming channel */
-    CyU3PDmaChannelDestroy (&glChHandleUVCStream);
+    glStreamMode = CY_FX_UVC_STREAM_READY;
 
-    /* Flush the endpoint memory */
+    /* Abort the video streaming channel and drop the data queued to the endpoint. */
+    CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyTrue);
+    CyU3PDmaChannelReset (&glChHandleUVCStream);
     CyU3PUsbFlushEp(CY_FX_EP_ISO_VIDEO);
 
-    /* Disable the video streaming endpoint. */
-    uvcVideoEpCfg.enable = CyFalse;
-    CyU3PSetEpConfig(CY_FX_EP_ISO_VIDEO, &uvcVideoEpCfg);
+    CY_FX_UVC_LOG (3, "App Stopped\r\n");
+}
+
+/* Post a message to the UVC application thread. Called from the USB callbacks, which must not block.
+ * A stop or release that does not fit in the queue is kept as the pending message, which is never
+ * dropped. Until the thread has handled it, the later messages are merged into it: a release
+ * replaces it, and a start replaces a pending stop because a start restarts the stream anyway. */
+static void
+CyFxUVCApplnPostMsg (
+        uint32_t type)
+{
+    CyFxUVCAppMsg_t msg;
+    CyBool_t dropped = CyFalse;
+    uint32_t posture;
+
+    msg.type     = type;
+    msg.postTime = CyFxUVCTimeUs ();
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    if (glPendingMsg.type != 0)
+    {
+        if ((type == CY_FX_UVC_MSG_RELEASE) || ((type == CY_FX_UVC_MSG_STOP) &&
+                    (glPendingMsg.type != CY_FX_UVC_MSG_RELEASE)) ||
+                ((type == CY_FX_UVC_MSG_START) && (glPendingMsg.type == CY_FX_UVC_MSG_STOP)))
+        {
+            glPendingMsg = msg;
+        }
+        else if (type != glPendingMsg.type)
+        {
+            dropped = CyTrue;
+        }
+        tx_interrupt_control (posture);
+    }
+    else
+    {
+        tx_interrupt_control (posture);
+
+        if (CyU3PQueueSend (&glAppQueue, &msg, CYU3P_NO_WAIT) == CY_U3P_SUCCESS)
+        {
+            glMsgQueued++;
+        }
+        else if ((type == CY_FX_UVC_MSG_STOP) || (type == CY_FX_UVC_MSG_RELEASE))
+        {
+            posture = tx_interrupt_control (TX_INT_DISABLE);
+            glPendingMsg    = msg;
+            glPendingMsgSeq = glMsgQueued;
+            tx_interrupt_control (posture);
+        }
+        else
+        {
+            dropped = CyTrue;
+        }
+    }
+
+    if (dropped)
+    {
+        CY_FX_UVC_LOG (4, "Application queue full, message %d dropped\r\n", type);
+        return;
+    }
+
+    CyU3PEventSet (&glStreamEvent, CY_FX_UVC_STREAM_EVT_MSG, CYU3P_EVENT_OR);
+}
+
+/* Take the next message for the UVC application thread: the pending message once the messages
+ * queued before it have been handled, else the next queued message. */
+static CyBool_t
+CyFxUVCApplnGetMsg (
+        CyFxUVCAppMsg_t *msg_p)
+{
+    uint32_t posture;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    if ((glPendingMsg.type != 0) && (glMsgReceived == glPendingMsgSeq))
+    {
+        *msg_p = glPendingMsg;
+        glPendingMsg.type = 0;
+        tx_interrupt_control (posture);
+        return CyTrue;
+    }
+    tx_interrupt_control (posture);
+
+    if (CyU3PQueueReceive (&glAppQueue, msg_p, CYU3P_NO_WAIT) != CY_U3P_SUCCESS)
+    {
+        return CyFalse;
+    }
 
-    CyU3PDebugPrint(3, "App Stopped\r\n");
+    glMsgReceived++;
+    return CyTrue;
 }
 
-/* This is the Callback function to handle the USB Events */
+/* This is the Callback function to handle the USB Events. The stream is started and stopped by the
+ * UVC application thread, to which the events are forwarded as messages. */
 static void
 CyFxUVCApplnUSBEventCB (
     CyU3PUsbEventType_t evtype, /* Event type */
@@ -310,11 +903,14 @@ CyFxUVCApplnUSBEventCB (
 {
     uint8_t interface = 0, altSetting = 0;
 
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_USB_EVENT, evtype, evdata, 0);
+
     switch (evtype)
     {
         case CY_U3P_USB_EVENT_SETCONF:
-            if (glIsApplnActive)
-                CyFxUVCApplnStop ();
+            /* A new configuration starts with a new stream channel. */
+            CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_SET_CONFIG);
+            CyFxUVCApplnPostMsg (CY_FX_UVC_MSG_RELEASE);
             if (evdata != 0)
                 glIsDevConfigured = CyTrue;
             break;
@@ -324,26 +920,25 @@ CyFxUVCApplnUSBEventCB (
             interface = CY_U3P_GET_MSB(evdata);
             altSetting = CY_U3P_GET_LSB(evdata);
 
-            /* Stop the application before re-starting. */
-            if (glIsApplnActive)
-            {
-                CyFxUVCApplnStop ();
-            }
+            /* Note the time of the request for the stream start measurement. */
+            glStreamLatency.startTime = CyFxUVCTimeUs ();
 
-            /* Start the video stream if the streaming interface has been selected. */
+            /* Start the video stream if the streaming interface has been selected. A running stream is
+             * stopped before re-starting. */
             if ((interface == CY_FX_UVC_INTERFACE_VS) && (altSetting != 0))
             {
-                CyFxUVCApplnStart ();
+                CyFxUVCApplnPostMsg (CY_FX_UVC_MSG_START);
+            }
+            else
+            {
+                CyFxUVCApplnPostMsg (CY_FX_UVC_MSG_STOP);
             }
             break;
 
         case CY_U3P_USB_EVENT_RESET:
         case CY_U3P_USB_EVENT_DISCONNECT:
-            /* Stop the video streamer application. */
-            if (glIsApplnActive)
-            {
-                CyFxUVCApplnStop ();
-            }
+            /* Stop the video streamer application and release the stream channel. */
+            CyFxUVCApplnPostMsg (CY_FX_UVC_MSG_RELEASE);
             glIsDevConfigured = CyFalse;
             break;
 
@@ -352,35 +947,372 @@ CyFxUVCApplnUSBEventCB (
     }
 }
 
-/* Callback to handle the USB Setup Requests and UVC Class events */
-static CyBool_t
-CyFxUVCApplnUSBSetupCB (
-        uint32_t setupdat0, /* SETUP Data 0 */
-        uint32_t setupdat1  /* SETUP Data 1 */
-    )
+/* Endpoint event callback, registered for the ISO error event of the video endpoint. For an IN
+ * endpoint, the event means that no data was ready when the host polled the endpoint, and that a
+ * zero length packet was sent instead. The data is late rather than lost, but the host sees a gap
+ * in the frame. The underrun is counted here and matched with a payload by the DMA consumer
+ * callback (CyFxUVCApplnCountUnderruns). Underruns while the stream is not running
+ * (endpoint NAKed or being flushed) are ignored. */
+static void
+CyFxUVCApplnEpEventCB (
+        CyU3PUsbEpEvtType evType,       /* Event type */
+        CyU3PUSBSpeed_t   usbSpeed,     /* Current USB connection speed */
+        uint8_t           epNum)        /* Endpoint number */
 {
-    uint16_t readCount = 0;
-    uint8_t  bRequest, bReqType;
-    uint8_t  bType, bTarget;
-    uint16_t wValue, wIndex;
-    CyBool_t isHandled = CyFalse;
-    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-    uint8_t  temp = 0;
+    if ((evType != CYU3P_USBEP_ISOERR_EVT) || (epNum != CY_FX_EP_ISO_VIDEO) ||
+            (glStreamMode != CY_FX_UVC_STREAM_ACTIVE))
+    {
+        return;
+    }
 
-    /* Fast enumeration is used. Only requests addressed to the interface, class,
-     * vendor and unknown control requests are received by this function. */
+    glUnderrunCount++;
+    glStreamStats.underrunCount++;
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_UNDERRUN, glUnderrunCount, usbSpeed, 0);
 
-    /* Decode the fields from the setup request. */
-    bReqType = (setupdat0 & CY_U3P_USB_REQUEST_TYPE_MASK);
-    bType    = (bReqType & CY_U3P_USB_TYPE_MASK);
-    bTarget  = (bReqType & CY_U3P_USB_TARGET_MASK);
-    bRequest = ((setupdat0 & CY_U3P_USB_REQUEST_MASK) >> CY_U3P_USB_REQUEST_POS);
-    wValue   = ((setupdat0 & CY_U3P_USB_VALUE_MASK)   >> CY_U3P_USB_VALUE_POS);
-    wIndex   = ((setupdat1 & CY_U3P_USB_INDEX_MASK)   >> CY_U3P_USB_INDEX_POS);
+    /* Let the application thread report the error on the status endpoint. A burst of underruns
+     * gives a single status packet. */
+    CyU3PEventSet (&glStreamEvent, CY_FX_UVC_STREAM_EVT_UNDERRUN, CYU3P_EVENT_OR);
+}
 
-    if (bType == CY_U3P_USB_STANDARD_RQT)
+/* Send a VideoStreaming status packet for the underruns of the video endpoint. */
+static void
+CyFxUVCApplnSendStreamError (
+        void)
+{
+    uint8_t packet[4];
+
+    packet[0] = CY_FX_UVC_STATUS_TYPE_VS;               /* bStatusType */
+    packet[1] = CY_FX_UVC_INTERFACE_VS;                 /* bOriginator */
+    packet[2] = CY_FX_UVC_STATUS_VS_STREAM_ERROR;       /* bEvent */
+    packet[3] = CY_FX_UVC_STREAM_ERR_UNDERRUN;          /* bValue */
+    CyFxUVCStatusSend (CY_FX_UVC_STATUS_CH_VC, packet, sizeof (packet));
+}
+
+/* Change of a statistics counter since the previous telemetry record. A counter that went down
+ * has been cleared by the host in between. */
+static uint32_t
+CyFxUVCApplnTelemetryDelta (
+        uint32_t current,
+        uint32_t last)
+{
+    return (current >= last) ? (current - last) : current;
+}
+
+/* Build a telemetry record and send it on the telemetry interface endpoint. */
+static void
+CyFxUVCApplnSendTelemetry (
+        void)
+{
+    CyFxUVCTelemetry_t record;
+    CyFxUVCStreamStats_t stats;
+    CyFxHeapStats_t heap;
+    uint32_t posture, now;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    CyU3PMemCopy ((uint8_t *)&stats, (uint8_t *)&glStreamStats, sizeof (CyFxUVCStreamStats_t));
+    tx_interrupt_control (posture);
+    now = CyFxUVCTimeUs ();
+
+    CyU3PMemSet ((uint8_t *)&record, 0, sizeof (record));
+    record.statusType    = CY_FX_UVC_STATUS_TYPE_TELEMETRY;
+    record.version       = CY_FX_UVC_TELEMETRY_VERSION;
+    record.streamMode    = glStreamMode;
+    record.sequence      = glTelemetrySequence++;
+    record.timeUs        = now;
+    record.periodUs      = now - glTelemetryTime;
+    record.byteCount     = (stats.byteCount >= glTelemetryLast.byteCount) ?
+        (uint32_t)(stats.byteCount - glTelemetryLast.byteCount) : (uint32_t)stats.byteCount;
+    record.frameCount    = CyFxUVCApplnTelemetryDelta (stats.frameCount, glTelemetryLast.frameCount);
+    record.underrunCount = CyFxUVCApplnTelemetryDelta (stats.underrunCount, glTelemetryLast.underrunCount);
+    record.dropCount     = CyFxUVCStatusDropCount ();
+
+#if CY_FX_UVC_CPU_LOAD_ENABLE
     {
-        /* Handle SET_FEATURE(FUNCTION_SUSPEND) and CLEAR_FEATURE(FUNCTION_SUSPEND)
+        CyFxUVCCpuLoad_t load;
+
+        CyFxUVCCpuGetLoad (&load);
+        record.cpuIdlePermille = load.idlePermille;
+    }
+#else
+    record.cpuIdlePermille = CY_FX_UVC_TELEMETRY_NO_CPU;
+#endif
+
+    CyU3PMemGetStats (&heap);
+    record.memUsed        = heap.usedSize;
+    record.memLargestFree = heap.largestFree;
+    CyU3PBufGetStats (&heap);
+    record.bufUsed        = heap.usedSize;
+    record.bufLargestFree = heap.largestFree;
+
+    glTelemetryTime = now;
+    CyU3PMemCopy ((uint8_t *)&glTelemetryLast, (uint8_t *)&stats, sizeof (CyFxUVCStreamStats_t));
+
+    CyFxUVCStatusSend (CY_FX_UVC_STATUS_CH_TELEMETRY, (uint8_t *)&record, sizeof (record));
+}
+
+/* Timer callback that asks the application thread for a telemetry record. */
+static void
+CyFxUVCApplnTelemetryTimerCb (
+        uint32_t input)
+{
+    CyU3PEventSet (&glStreamEvent, CY_FX_UVC_STREAM_EVT_TELEMETRY, CYU3P_EVENT_OR);
+}
+
+/* Account the time from the consumer event that freed a buffer to the commit of that buffer. The
+ * buffers are used in order, so once every buffer has been committed once, the N-th commit refills
+ * the buffer freed by the N-th consumer event after that. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnLatencyCommit (
+        uint32_t commitTime)    /* Time (us) at which the buffer was committed */
+{
+    uint32_t latency;
+
+    if (glStreamLatency.commitCount++ < glStreamState.bufCount)
+        return;
+
+    if (glStreamLatency.eventTail != glStreamLatency.eventHead)
+    {
+        latency = commitTime - glEventTimes[glStreamLatency.eventTail & (CY_FX_UVC_EVENT_RING_SIZE - 1)];
+        glStreamLatency.eventTail++;
+        glStreamLatency.sampleCount++;
+        glStreamLatency.totalUs += latency;
+        if (latency > glStreamLatency.maxUs)
+            glStreamLatency.maxUs = latency;
+    }
+}
+
+/* Write the first length bytes of a buffer back from the D-cache before the buffer is handed to
+ * the DMA engine. Nothing needs to be done when the D-cache is off or maintained by the SDK. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnCleanBuffer (
+        uint8_t  *buffer_p,     /* 32 byte aligned buffer pointer */
+        uint32_t  length        /* Number of bytes filled by the CPU */
+    )
+{
+#if (CY_FX_UVC_DCACHE_ENABLE) && (!CY_FX_UVC_DCACHE_SDK_MAINT)
+    CyU3PSysCleanDRegion ((uint32_t *)buffer_p, (length + 31) & ~31);
+#endif
+}
+
+/* Handle the vendor specific requests used to read out diagnostic information. Returns
+ * CyFalse for unknown requests so that they are stalled by the USB driver. */
+static CyBool_t
+CyFxUVCApplnVendorRqt (
+        uint8_t  bReqType,
+        uint8_t  bRequest,
+        uint16_t wValue,
+        uint16_t wIndex,
+        uint16_t wLength)
+{
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    uint16_t length = 0;
+    uint32_t posture;
+
+    if ((bReqType == CY_FX_USB_VENDOR_SET_REQ_TYPE) && (bRequest == CY_FX_RQT_SET_HEADER_FORMAT) &&
+            (wLength == 0))
+    {
+        /* wValue is the header format. It is used from the next commit of the stream settings on. */
+        if (wValue >= CY_FX_UVC_HEADER_FMT_COUNT)
+        {
+            return CyFalse;
+        }
+
+        glHeaderFormatReq = (uint8_t)wValue;
+        CyU3PUsbAckSetup ();
+        return CyTrue;
+    }
+
+    if ((bReqType == CY_FX_USB_VENDOR_SET_REQ_TYPE) && (bRequest == CY_FX_RQT_RESET_STREAM_STATS) &&
+            (wLength == 0))
+    {
+        /* Interrupts are disabled so that no thread updates a counter while the block is cleared. */
+        posture = tx_interrupt_control (TX_INT_DISABLE);
+        CyU3PMemSet ((uint8_t *)&glStreamStats, 0, sizeof (CyFxUVCStreamStats_t));
+        CyU3PMemSet ((uint8_t *)glStageHist, 0, sizeof (glStageHist));
+        tx_interrupt_control (posture);
+
+        CyU3PUsbAckSetup ();
+        return CyTrue;
+    }
+
+#if CY_FX_UVC_TRACE_ENABLE
+    if ((bReqType == CY_FX_USB_VENDOR_SET_REQ_TYPE) && (bRequest == CY_FX_RQT_TRACE_CONTROL) &&
+            (wLength == 0))
+    {
+        /* wValue: 0 = pause, 1 = resume, 2 = clear and resume. */
+        if (wValue > 2)
+        {
+            return CyFalse;
+        }
+
+        CyFxUVCTraceControl ((wValue != 0), (wValue == 2));
+        CyU3PUsbAckSetup ();
+        return CyTrue;
+    }
+#endif
+
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+    if ((bReqType == CY_FX_USB_VENDOR_SET_REQ_TYPE) && (bRequest == CY_FX_RQT_PROFILE_CONTROL) &&
+            (wLength == 0))
+    {
+        /* wValue: 0 = stop, 1 = start, 2 = clear and start. wIndex is the sampling rate in Hz,
+         * 0 for the default rate. */
+        if ((wValue > 2) || (CyFxUVCProfControl ((wValue != 0), (wValue == 2), wIndex) != CY_U3P_SUCCESS))
+        {
+            return CyFalse;
+        }
+
+        CyU3PUsbAckSetup ();
+        return CyTrue;
+    }
+#endif
+
+    if ((bReqType == CY_FX_USB_VENDOR_SET_REQ_TYPE) && (bRequest == CY_FX_RQT_TELEMETRY_CONTROL) &&
+            (wLength == 0) && (glTelemetryReady))
+    {
+        /* wValue is the interval between telemetry records in ms, 0 to stop them. The request is
+         * stalled until the thread has created the timer, which a fast boot does after connecting. */
+        CyU3PTimerStop (&glTelemetryTimer);
+        if (wValue != 0)
+        {
+            CyU3PTimerModify (&glTelemetryTimer, wValue, wValue);
+            CyU3PTimerStart (&glTelemetryTimer);
+        }
+
+        CyU3PUsbAckSetup ();
+        return CyTrue;
+    }
+
+    if (bReqType != CY_FX_USB_VENDOR_GET_REQ_TYPE)
+    {
+        return CyFalse;
+    }
+
+    switch (bRequest)
+    {
+        case CY_FX_RQT_GET_HEAP_STATS:
+            /* Driver heap statistics followed by the buffer heap statistics. */
+            CyU3PMemGetStats ((CyFxHeapStats_t *)glEp0Buffer);
+            CyU3PBufGetStats ((CyFxHeapStats_t *)(glEp0Buffer + sizeof (CyFxHeapStats_t)));
+            length = 2 * sizeof (CyFxHeapStats_t);
+            break;
+
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+        case CY_FX_RQT_GET_MEM_CHECK:
+            CyU3PMemCopy (glEp0Buffer, (uint8_t *)&glMemCheckStats, sizeof (CyFxUVCMemCheckStats_t));
+            length = sizeof (CyFxUVCMemCheckStats_t);
+            break;
+
+        case CY_FX_RQT_GET_HEAP_BLOCKS:
+            /* wValue selects the heap (0 = driver heap, 1 = buffer heap) and wIndex is the number of
+             * blocks to skip. A response shorter than the buffer marks the end of the list. */
+            if (wValue == 0)
+                length = CyU3PMemGetInUseBlocks ((CyFxBlockRecord_t *)glEp0Buffer, wIndex,
+                        CY_FX_EP0_BUFFER_SIZE / sizeof (CyFxBlockRecord_t));
+            else
+                length = CyU3PBufGetInUseBlocks ((CyFxBlockRecord_t *)glEp0Buffer, wIndex,
+                        CY_FX_EP0_BUFFER_SIZE / sizeof (CyFxBlockRecord_t));
+            length *= sizeof (CyFxBlockRecord_t);
+            break;
+#endif
+
+        case CY_FX_RQT_GET_BOOT_PROFILE:
+            CyU3PMemCopy (glEp0Buffer, (uint8_t *)&glBootProfile, sizeof (CyFxUVCBootProfile_t));
+            length = sizeof (CyFxUVCBootProfile_t);
+            break;
+
+        case CY_FX_RQT_GET_STREAM_STATS:
+            /* The counters are updated by the application thread and the DMA callback. Copy them with
+             * interrupts disabled, so that no thread can update them half-way through the copy. */
+            posture = tx_interrupt_control (TX_INT_DISABLE);
+            CyU3PMemCopy (glEp0Buffer, (uint8_t *)&glStreamStats, sizeof (CyFxUVCStreamStats_t));
+            tx_interrupt_control (posture);
+            length = sizeof (CyFxUVCStreamStats_t);
+            break;
+
+        case CY_FX_RQT_GET_STAGE_HIST:
+            /* One CyFxUVCHistogram_t per stage, in CY_FX_UVC_STAGE_* order. */
+            posture = tx_interrupt_control (TX_INT_DISABLE);
+            CyU3PMemCopy (glEp0Buffer, (uint8_t *)glStageHist, sizeof (glStageHist));
+            tx_interrupt_control (posture);
+            length = sizeof (glStageHist);
+            break;
+
+#if CY_FX_UVC_STACK_USAGE_ENABLE
+        case CY_FX_RQT_GET_STACK_USAGE:
+            /* One CyFxUVCStackUsage_t per thread; the length of the response gives the count. */
+            length = CyFxUVCStackGetUsage ((CyFxUVCStackUsage_t *)glEp0Buffer,
+                    CY_FX_EP0_BUFFER_SIZE / sizeof (CyFxUVCStackUsage_t)) * sizeof (CyFxUVCStackUsage_t);
+            break;
+#endif
+
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+        case CY_FX_RQT_GET_CPU_LOAD:
+            CyFxUVCCpuGetLoad ((CyFxUVCCpuLoad_t *)glEp0Buffer);
+            length = sizeof (CyFxUVCCpuLoad_t);
+            break;
+#endif
+
+#if CY_FX_UVC_TRACE_ENABLE
+        case CY_FX_RQT_GET_TRACE:
+            /* wIndex is the byte offset in the trace area. A response shorter than the buffer
+             * marks the end of the area. */
+            length = CyFxUVCTraceRead (glEp0Buffer, wIndex, CY_FX_EP0_BUFFER_SIZE);
+            break;
+#endif
+
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+        case CY_FX_RQT_GET_PROFILE:
+            /* wIndex is the byte offset in the histogram area, as for the trace. */
+            length = CyFxUVCProfRead (glEp0Buffer, wIndex, CY_FX_EP0_BUFFER_SIZE);
+            break;
+#endif
+
+        default:
+            return CyFalse;
+    }
+
+    CyFxUVCApplnCleanBuffer (glEp0Buffer, length);
+    status = CyU3PUsbSendEP0Data (CY_U3P_MIN (length, wLength), glEp0Buffer);
+    if (status != CY_U3P_SUCCESS)
+    {
+        CY_FX_UVC_LOG (4, "CyU3PUsbSendEP0Data, error code = %d\n", status);
+    }
+
+    return CyTrue;
+}
+
+/* Callback to handle the USB Setup Requests and UVC Class events */
+static CyBool_t
+CyFxUVCApplnUSBSetupCB (
+        uint32_t setupdat0, /* SETUP Data 0 */
+        uint32_t setupdat1  /* SETUP Data 1 */
+    )
+{
+    uint16_t readCount = 0;
+    uint8_t  bRequest, bReqType;
+    uint8_t  bType, bTarget;
+    uint16_t wValue, wIndex, wLength;
+    CyBool_t isHandled = CyFalse;
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    uint32_t setupTime = CyFxUVCTimeUs ();
+
+    /* Fast enumeration is used. Only requests addressed to the interface, class,
+     * vendor and unknown control requests are received by this function. */
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_SETUP, setupdat0, setupdat1, 0);
+
+    /* Decode the fields from the setup request. */
+    bReqType = (setupdat0 & CY_U3P_USB_REQUEST_TYPE_MASK);
+    bType    = (bReqType & CY_U3P_USB_TYPE_MASK);
+    bTarget  = (bReqType & CY_U3P_USB_TARGET_MASK);
+    bRequest = ((setupdat0 & CY_U3P_USB_REQUEST_MASK) >> CY_U3P_USB_REQUEST_POS);
+    wValue   = ((setupdat0 & CY_U3P_USB_VALUE_MASK)   >> CY_U3P_USB_VALUE_POS);
+    wIndex   = ((setupdat1 & CY_U3P_USB_INDEX_MASK)   >> CY_U3P_USB_INDEX_POS);
+    wLength  = ((setupdat1 & CY_U3P_USB_LENGTH_MASK)  >> CY_U3P_USB_LENGTH_POS);
+
+    if (bType == CY_U3P_USB_STANDARD_RQT)
+    {
+        /* Handle SET_FEATURE(FUNCTION_SUSPEND) and CLEAR_FEATURE(FUNCTION_SUSPEND)
          * requests here. It should be allowed to pass if the device is in configured
          * state and failed otherwise. */
         if ((bTarget == CY_U3P_USB_TARGET_INTF) && ((bRequest == CY_U3P_USB_SC_SET_FEATURE)
@@ -398,7 +1330,7 @@ CyFxUVCApplnUSBSetupCB (
     /* Check for UVC Class Requests */
     if (bType == CY_U3P_USB_CLASS_RQT)
     {
-        CyU3PDebugPrint (4, "UVC RQT: %x %x %x %x %x\r\n", bTarget, bRequest, CY_U3P_GET_MSB(wIndex),
+        CY_FX_UVC_LOG (4, "UVC RQT: %x %x %x %x %x\r\n", bTarget, bRequest, CY_U3P_GET_MSB(wIndex),
                 CY_U3P_GET_LSB(wIndex), wValue);
 
         /* Handle requests addressed to the Video Control interface. */
@@ -408,9 +1340,11 @@ CyFxUVCApplnUSBSetupCB (
                any of the Video Control features */
             if ((CY_U3P_GET_MSB(wIndex) == 0x00) && (wValue == CY_FX_USB_UVC_VC_RQT_ERROR_CODE_CONTROL))
             {
-                temp      = CY_FX_USB_UVC_RQT_STAT_INVALID_CTRL;
-                isHandled = CyTrue;
-                CyU3PUsbSendEP0Data (0x01, &temp);
+                /* The data is sent from the aligned EP0 buffer as it is read by the DMA engine. */
+                glEp0Buffer[0] = CY_FX_USB_UVC_RQT_STAT_INVALID_CTRL;
+                isHandled      = CyTrue;
+                CyFxUVCApplnCleanBuffer (glEp0Buffer, 1);
+                CyU3PUsbSendEP0Data (0x01, glEp0Buffer);
             }
         }
 
@@ -440,7 +1374,7 @@ CyFxUVCApplnUSBSetupCB (
                                         (uint8_t *)glProbeCtrl);
                                 if (status != CY_U3P_SUCCESS)
                                 {
-                                    CyU3PDebugPrint (4, "CyU3PUsbSendEP0Data, error code = %d\n", status);
+                                    CY_FX_UVC_LOG (4, "CyU3PUsbSendEP0Data, error code = %d\n", status);
                                 }
                                 break;
 
@@ -453,14 +1387,24 @@ CyFxUVCApplnUSBSetupCB (
                                         glCommitCtrl, &readCount);
                                 if (status != CY_U3P_SUCCESS)
                                 {
-                                    CyU3PDebugPrint (4, "CyU3PUsbGetEP0Data failed, error code = %d\n", status);
+                                    CY_FX_UVC_LOG (4, "CyU3PUsbGetEP0Data failed, error code = %d\n", status);
                                 }
                                 else
                                 {
+#if (CY_FX_UVC_DCACHE_ENABLE) && (!CY_FX_UVC_DCACHE_SDK_MAINT)
+                                    /* Drop any stale cached copy of the data written by the DMA engine. */
+                                    CyU3PSysFlushDRegion ((uint32_t *)glCommitCtrl, CY_FX_UVC_MAX_PROBE_SETTING_ALIGNED);
+#endif
+
                                     /* Check the read count. Expecting a count of CY_FX_UVC_MAX_PROBE_SETTING bytes. */
                                     if (readCount != (uint16_t)CY_FX_UVC_MAX_PROBE_SETTING)
                                     {
-                                        CyU3PDebugPrint (4, "Invalid number of bytes received in SET_CUR Request");
+                                        CY_FX_UVC_LOG (4, "Invalid number of bytes received in SET_CUR Request");
+                                    }
+                                    else if (wValue == CY_FX_USB_UVC_VS_COMMIT_CONTROL)
+                                    {
+                                        /* Let the application thread prepare the stream channel. */
+                                        CyFxUVCApplnPostMsg (CY_FX_UVC_MSG_COMMIT);
                                     }
                                 }
                                 break;
@@ -472,6 +1416,21 @@ CyFxUVCApplnUSBSetupCB (
                     }
                     break;
 
+                case CY_FX_USB_UVC_VS_STREAM_ERROR_CODE_CONTROL:
+                    /* Report the last stream error once, as for the request error code control. */
+                    if (bRequest == CY_FX_USB_UVC_GET_CUR_REQ)
+                    {
+                        glEp0Buffer[0]    = glStreamErrorCode;
+                        glStreamErrorCode = CY_FX_UVC_STREAM_ERR_NONE;
+                        CyFxUVCApplnCleanBuffer (glEp0Buffer, 1);
+                        CyU3PUsbSendEP0Data (0x01, glEp0Buffer);
+                    }
+                    else
+                    {
+                        CyU3PUsbStall (0, CyTrue, CyFalse);
+                    }
+                    break;
+
                 default:
                     CyU3PUsbStall (0, CyTrue, CyFalse);
                     break;
@@ -481,6 +1440,18 @@ CyFxUVCApplnUSBSetupCB (
         /* Don't try to stall the endpoint if we have already attempted data transfer. */
     }
 
+    /* Check for the vendor specific diagnostic requests. */
+    if ((bType == CY_U3P_USB_VENDOR_RQT) && (bTarget == CY_U3P_USB_TARGET_DEVICE))
+    {
+        isHandled = CyFxUVCApplnVendorRqt (bReqType, bRequest, wValue, wIndex, wLength);
+    }
+    else if (isHandled)
+    {
+        /* Time from the setup packet to the ack or the end of the data phase, with the logging of
+         * the request. The diagnostic vendor requests are left out. */
+        CyFxUVCApplnHistAdd (CY_FX_UVC_STAGE_SETUP, CyFxUVCTimeUs () - setupTime);
+    }
+
     return isHandled;
 }
 
@@ -508,6 +1479,31 @@ CyFxUVCApplnInit (void)
     CyU3PEpConfig_t endPointConfig;
     CyU3PReturnStatus_t apiRetStatus = CY_U3P_SUCCESS;
 
+    /* The variables placed in D-TCM are not loaded from the firmware image. */
+    CyU3PMemCopy (glUVCHeader, (uint8_t *)glUVCHeaderDefault, CY_FX_UVC_MAX_HEADER);
+    CyU3PMemSet ((uint8_t *)&glStreamState, 0, sizeof (glStreamState));
+    glStreamState.bufSize      = CY_FX_UVC_STREAM_BUF_SIZE;
+    glStreamState.bufCount     = CY_FX_UVC_STREAM_BUF_COUNT;
+    glStreamState.headerFormat = CY_FX_UVC_HEADER_FORMAT;
+    glStreamState.headerLen    = CY_FX_UVC_MAX_HEADER;
+    CurrentMultVal = 1;
+
+    /* Create the event and the message queue used to wake up the application thread. */
+    apiRetStatus = CyU3PEventCreate (&glStreamEvent);
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Stream event create failed, Error Code = %d\r\n", apiRetStatus);
+        CyFxAppErrorHandler (apiRetStatus);
+    }
+
+    apiRetStatus = CyU3PQueueCreate (&glAppQueue, sizeof (CyFxUVCAppMsg_t) / sizeof (uint32_t), glAppQueueBuf,
+            sizeof (glAppQueueBuf));
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Application queue create failed, Error Code = %d\r\n", apiRetStatus);
+        CyFxAppErrorHandler (apiRetStatus);
+    }
+
     /* Start the USB functionality */
     apiRetStatus = CyU3PUsbStart();
     if (apiRetStatus != CY_U3P_SUCCESS)
@@ -515,6 +1511,7 @@ CyFxUVCApplnInit (void)
         CyU3PDebugPrint (4, "USB Function Failed to Start, Error Code = %d\r\n",apiRetStatus);
         CyFxAppErrorHandler(apiRetStatus);
     }
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_USB_START);
 
     /* The fast enumeration is the easiest way to setup a USB connection,
      * where all enumeration phase is handled by the library. Only the
@@ -524,6 +1521,14 @@ CyFxUVCApplnInit (void)
     /* Setup the callback to handle the USB events */
     CyU3PUsbRegisterEventCallback(CyFxUVCApplnUSBEventCB);
 
+    /* Setup the callback to count the underruns of the video endpoint. */
+    apiRetStatus = CyU3PUsbRegisterEpEvtCallback (CyFxUVCApplnEpEventCB, CYU3P_USBEP_ISOERR_EVT, 0,
+            1 << (CY_FX_EP_ISO_VIDEO & 0x0F));
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "USB endpoint event callback registration failed, Error code = %d\r\n", apiRetStatus);
+    }
+
     /* Register a callback to handle LPM requests from the USB 3.0 host. */
     CyU3PUsbRegisterLPMRequestCallback(CyFxApplnLPMRqtCB);    
     
@@ -585,8 +1590,8 @@ CyFxUVCApplnInit (void)
         CyFxAppErrorHandler(apiRetStatus);
     }
 
-    /* Since the status interrupt endpoint is not used in this application,
-     * just enable the EP in the beginning. */
+    /* The status interrupt endpoint and the telemetry endpoint are enabled once, at the beginning,
+     * and fed by the status channels (cyfxuvcstatus.h). */
     /* Control status interrupt endpoint configuration */
     endPointConfig.enable = 1;
     endPointConfig.epType = CY_U3P_USB_EP_INTR;
@@ -601,6 +1606,21 @@ CyFxUVCApplnInit (void)
         CyFxAppErrorHandler(apiRetStatus);
     }
 
+    /* Telemetry interrupt endpoint configuration: same settings. */
+    apiRetStatus = CyU3PSetEpConfig(CY_FX_EP_TELEMETRY, &endPointConfig);
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "CyU3PSetEpConfig failed, error code = %d\r\n",apiRetStatus);
+        CyFxAppErrorHandler(apiRetStatus);
+    }
+
+    /* Without the status channels, the device still streams but sends no status packets. */
+    apiRetStatus = CyFxUVCStatusInit ();
+    if (apiRetStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Status channel create failed, error code = %d\r\n", apiRetStatus);
+    }
+
     /* Connect the USB pins and enable super speed operation */
     apiRetStatus = CyU3PConnectState(CyTrue, CyFalse);
     if (apiRetStatus != CY_U3P_SUCCESS)
@@ -608,185 +1628,833 @@ CyFxUVCApplnInit (void)
         CyU3PDebugPrint (4, "USB connect failed, Error Code = %d\r\n",apiRetStatus);
         CyFxAppErrorHandler(apiRetStatus);
     }
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_CONNECT);
 }
 
-/* UVC header addition function */
-static void
+/* Store a 32-bit value in little endian byte order. */
+static CY_FX_ITCM_CODE void
+CyFxUVCStoreLE32 (
+        uint8_t  *dst_p,
+        uint32_t  value)
+{
+    dst_p[0] = CY_U3P_DWORD_GET_BYTE0 (value);
+    dst_p[1] = CY_U3P_DWORD_GET_BYTE1 (value);
+    dst_p[2] = CY_U3P_DWORD_GET_BYTE2 (value);
+    dst_p[3] = CY_U3P_DWORD_GET_BYTE3 (value);
+}
+
+/* USB frame number for the SOF token counter of the SCR (11 bits, 1 ms per count). At Hi-Speed it is
+ * taken from the frame count of the last SOF, which has the micro-frame number in bits 2:0. At
+ * SuperSpeed, where there are no SOF tokens, it is taken from the bus interval counter (125 us per
+ * count) of the last isochronous timestamp packet in the same way. 0 if the count can not be read. */
+static CY_FX_ITCM_CODE uint16_t
+CyFxUVCApplnSofCount (
+        void)
+{
+    uint32_t value = 0;
+    CyU3PUsbDevProperty prop = (CyU3PUsbGetSpeed () == CY_U3P_SUPER_SPEED) ?
+        CY_U3P_USB_PROP_ITPINFO : CY_U3P_USB_PROP_FRAMECNT;
+
+    if (CyU3PUsbGetDevProperty (prop, &value) != CY_U3P_SUCCESS)
+    {
+        return 0;
+    }
+
+    return (uint16_t)((value >> 3) & 0x07FF);
+}
+
+/* UVC header addition function. The PTS is the fill time of the first payload of a frame and is
+ * kept for the rest of the frame; the SCR carries the fill time of each payload and the USB frame
+ * number at that time. */
+static CY_FX_ITCM_CODE void
 CyFxUVCAddHeader (
         uint8_t *buffer_p, /* Buffer pointer */
-        uint8_t frameInd   /* EOF or normal frame indication */
+        uint8_t frameInd,  /* EOF or normal frame indication */
+        uint32_t fillTime  /* Time (us) at which the payload is filled */
     )
 {
+    uint32_t posture;
+    uint16_t sofCount;
+
+    if (glStreamState.ptsPending && (glStreamState.headerLen > 2))
+    {
+        CyFxUVCStoreLE32 (&glUVCHeader[2], fillTime);
+        glStreamState.ptsPending = 0;
+    }
+    if (glStreamState.headerLen == CY_FX_UVC_MAX_HEADER)
+    {
+        CyFxUVCStoreLE32 (&glUVCHeader[6], fillTime);
+        sofCount = CyFxUVCApplnSofCount ();
+        glUVCHeader[10] = CY_U3P_GET_LSB (sofCount);
+        glUVCHeader[11] = CY_U3P_GET_MSB (sofCount);
+    }
+
     /* Copy header to buffer */
-    CyU3PMemCopy (buffer_p, (uint8_t *)glUVCHeader, CY_FX_UVC_MAX_HEADER);
+    CyU3PMemCopy (buffer_p, (uint8_t *)glUVCHeader, glStreamState.headerLen);
+
+    /* Mark this payload if an underrun happened while an earlier payload of the same frame was sent.
+     * The host can read the cause with VS_STREAM_ERROR_CODE_CONTROL. The consumer callback sets the
+     * mark, so it is taken and the frame count moved on with interrupts disabled. */
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    if (glStreamState.errFrame == glStreamState.fillFrame + 1)
+    {
+        buffer_p[1] |= CY_FX_UVC_HEADER_ERR;
+        glStreamState.errFrame = 0;
+    }
+    if (frameInd == CY_FX_UVC_HEADER_EOF)
+    {
+        glStreamState.fillFrame++;
+    }
+    tx_interrupt_control (posture);
 
     /* Check if last packet of the frame. */
     if (frameInd == CY_FX_UVC_HEADER_EOF)
     {
-        /* Modify UVC header to toggle Frame ID */
+        /* Modify UVC header to toggle Frame ID, and take a new PTS for the next frame. */
         glUVCHeader[1] ^= CY_FX_UVC_HEADER_FRAME_ID;
+        glStreamState.ptsPending = 1;
 
         /* Indicate End of Frame in the buffer */
         buffer_p[1] |=  CY_FX_UVC_HEADER_EOF;
     }
 }
 
-/* Entry function for the UVC application thread. */
-void
-UVCAppThread_Entry (
-        uint32_t input)
+/* Commit a filled stream buffer. At Hi-Speed, the ISO MULT setting is updated in a safe manner
+ * around the commit if the current setting does not match expectMult, the value expected for
+ * the size of this buffer. */
+static CY_FX_ITCM_CODE CyU3PReturnStatus_t
+CyFxUVCApplnCommitBuffer (
+        uint16_t commitLength,  /* Number of bytes in the buffer including the header */
+        uint8_t  expectMult     /* MULT value expected for this buffer */
+    )
+{
+    CyU3PReturnStatus_t status;
+
+    if ((CyU3PUsbGetSpeed () == CY_U3P_HIGH_SPEED) && (CurrentMultVal != expectMult))
+    {
+        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyTrue);
+        CyU3PBusyWait (10);
+        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
+        CyU3PBusyWait (20);
+        CyFxUvcAppSetMultByEpm (CY_FX_EP_ISO_VIDEO & 0x0F);
+        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
+    }
+    else
+    {
+        /* No change to mult setting, or not Hi-speed operation. Just commit the data. */
+        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
+    }
+
+    return status;
+}
+
+#if CY_FX_UVC_PRODUCER_CALLBACK
+/* Copy the next payload of the video clip, taken from the payload plan, and its UVC header into a
+ * stream buffer. Returns the number of bytes to commit, and sets expectMult_p to the MULT value
+ * expected for the buffer at Hi-Speed. */
+static CY_FX_ITCM_CODE uint16_t
+CyFxUVCApplnLoadPayload (
+        uint8_t *buffer_p,      /* Stream buffer to fill */
+        uint8_t *expectMult_p,  /* Return: MULT value expected for this buffer */
+        uint32_t fillTime       /* Time (us) for the PTS and SCR of the UVC header */
+    )
+{
+    const CyFxUVCPayload_t *payload_p = &glPayloadPlan[glStreamState.planIndex];
+    uint16_t commitLength;
+
+    CyU3PMemCopy (buffer_p + glStreamState.headerLen, (uint8_t *)&glUVCVidFrames[payload_p->offset],
+            payload_p->length);
+    commitLength = payload_p->length + glStreamState.headerLen;
+
+    if (payload_p->isEof)
+    {
+        CyFxUVCAddHeader (buffer_p, CY_FX_UVC_HEADER_EOF, fillTime);
+        *expectMult_p = (commitLength / 1024) + 1;
+    }
+    else
+    {
+        CyFxUVCAddHeader (buffer_p, CY_FX_UVC_HEADER_FRAME, fillTime);
+        *expectMult_p = CY_FX_EP_ISO_VIDEO_PKTS_COUNT;
+    }
+
+    glStreamState.planIndex++;
+    if (glStreamState.planIndex >= glStreamState.planCount)
+        glStreamState.planIndex = 0;
+
+    return commitLength;
+}
+#else
+/* Copy the next payload of the video clip and its UVC header into a stream buffer, and move on to
+ * the next payload. Returns the number of bytes to commit, and sets expectMult_p to the MULT value
+ * expected for the buffer at Hi-Speed. */
+static CY_FX_ITCM_CODE uint16_t
+CyFxUVCApplnLoadPayload (
+        uint8_t *buffer_p,      /* Stream buffer to fill */
+        uint8_t *expectMult_p,  /* Return: MULT value expected for this buffer */
+        uint32_t fillTime       /* Time (us) for the PTS and SCR of the UVC header */
+    )
+{
+    uint16_t commitLength;
+    uint16_t headerLen = glStreamState.headerLen;
+
+    /* Check if packet is last packet or first/intermediate packet */
+    if (glStreamState.frameOffset + (glStreamState.bufSize - headerLen) <
+            glVidFrameLen[glStreamState.frameIndex])
+    {
+        /* Load the video data to the OUT buffer */
+        CyU3PMemCopy ((buffer_p + headerLen),
+                (uint8_t *)&glUVCVidFrames[glStreamState.frameStart + glStreamState.frameOffset],
+                (glStreamState.bufSize - headerLen));
+
+        /* Add header with normal frame indication */
+        CyFxUVCAddHeader (buffer_p, CY_FX_UVC_HEADER_FRAME, fillTime);
+
+        /* Commit buffer length */
+        commitLength  = glStreamState.bufSize;
+        *expectMult_p = CY_FX_EP_ISO_VIDEO_PKTS_COUNT;
+
+        /* Update the index for video data */
+        glStreamState.frameOffset += (glStreamState.bufSize - headerLen);
+    }
+    else
+    {
+        /* Last packet of the video frame. Send this data and then reset all counters. */
+
+        /* Load the video data to the OUT buffer */
+        CyU3PMemCopy (buffer_p + headerLen,
+                (uint8_t *)&glUVCVidFrames[glStreamState.frameStart + glStreamState.frameOffset],
+                (glVidFrameLen[glStreamState.frameIndex] - glStreamState.frameOffset));
+
+        /* Commit buffer length */
+        commitLength = (glVidFrameLen[glStreamState.frameIndex] - glStreamState.frameOffset)
+            + headerLen;
+        *expectMult_p = (commitLength / 1024) + 1;
+
+        /* Add the header with End of Frame Indication */
+        CyFxUVCAddHeader (buffer_p, CY_FX_UVC_HEADER_EOF, fillTime);
+
+        /* Reset the Index for the next frame */
+        glStreamState.frameOffset = 0;
+        glStreamState.frameStart += glVidFrameLen[glStreamState.frameIndex];
+        glStreamState.frameIndex++;
+
+        /* If all frames are transferred then start from 0 */
+        if (glStreamState.frameIndex >= CY_FX_UVC_MAX_VID_FRAMES)
+        {
+            glStreamState.frameIndex = 0;
+            glStreamState.frameStart = 0;
+        }
+    }
+
+    return commitLength;
+}
+#endif
+
+/* Update the streaming statistics for a buffer commit. The EOF bit is read back from the UVC
+ * header in the buffer, which is still in the cache. The buffer, byte and frame counts are
+ * updated together with interrupts disabled, so that a snapshot never sees only some of them. */
+static CY_FX_ITCM_CODE void
+CyFxUVCApplnCountCommit (
+        const uint8_t *buffer_p,        /* Stream buffer that was committed */
+        uint16_t commitLength,          /* Number of bytes committed */
+        CyU3PReturnStatus_t status)     /* Result of the commit */
+{
+    uint32_t isEof = ((buffer_p[1] & CY_FX_UVC_HEADER_EOF) != 0);
+    uint32_t isErr = ((buffer_p[1] & CY_FX_UVC_HEADER_ERR) != 0);
+    uint32_t posture;
+
+    if (status != CY_U3P_SUCCESS)
+    {
+        glStreamStats.commitFailCount++;
+        return;
+    }
+
+    /* Note where the frames end for the underrun accounting of the consumer callback. */
+    glPayloadEof[glStreamState.payloadCount++ & (CY_FX_UVC_EVENT_RING_SIZE - 1)] = isEof;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    glStreamStats.bufCount++;
+    glStreamStats.byteCount += commitLength;
+    glStreamStats.frameCount += isEof;
+    glStreamStats.errPayloadCount += isErr;
+    tx_interrupt_control (posture);
+}
+
+/* Fill a stream buffer with the next payload and commit it. The wait for the buffer and the time
+ * taken by the fill and the commit are added to the stage histograms. The time is read once at
+ * each stage boundary: the fill time also goes into the UVC header, the commit time is the
+ * latency sample, and the time at the end of the commit starts the wait for the next buffer. */
+static CY_FX_ITCM_CODE CyU3PReturnStatus_t
+CyFxUVCApplnSendPayload (
+        uint8_t *buffer_p,      /* Stream buffer obtained from the channel */
+        uint32_t requestTime,   /* Time (us) at which the producer started asking for a buffer */
+        uint32_t *doneTime_p)   /* Return: time (us) at the end of the commit */
+{
+    uint16_t commitLength;
+    uint8_t  expectMult;
+    uint32_t fillTime, commitTime, doneTime;
+    CyU3PReturnStatus_t status;
+
+    fillTime = CyFxUVCTimeUs ();
+    commitLength = CyFxUVCApplnLoadPayload (buffer_p, &expectMult, fillTime);
+    CyFxUVCApplnCleanBuffer (buffer_p, commitLength);
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_FILL, buffer_p, commitLength, 0);
+
+    commitTime = CyFxUVCTimeUs ();
+    status = CyFxUVCApplnCommitBuffer (commitLength, expectMult);
+    doneTime = CyFxUVCTimeUs ();
+    *doneTime_p = doneTime;
+
+    CyFxUVCApplnHistAddBuffer (fillTime - requestTime, commitTime - fillTime, doneTime - commitTime);
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_COMMIT, status, commitLength, expectMult);
+    CyFxUVCApplnCountCommit (buffer_p, commitLength, status);
+    if (status == CY_U3P_SUCCESS)
+    {
+        CY_FX_UVC_PROFILE_BUFFER (fillTime, doneTime);
+        CyFxUVCApplnLatencyCommit (commitTime);
+    }
+
+    return status;
+}
+
+/* Fill up to CY_FX_UVC_STREAM_PREFILL_COUNT stream buffers with the first payloads of the clip. Called
+ * from CyFxUVCApplnStart while the endpoint is NAKed, so that the host gets video data from the first
+ * service intervals on, without waiting for the producer. The MULT setting is not changed between
+ * these buffers; it is set from the EPM once the caller has queued them. */
+static CyU3PReturnStatus_t
+CyFxUVCApplnPrefill (
+        void)
 {
     CyU3PDmaBuffer_t dmaBuffer;
-    uint16_t commitLength = 0;
-    uint32_t frameStart = 0, frameIndex = 0, frameOffset = 0;
+    uint32_t count = CY_U3P_MIN (CY_FX_UVC_STREAM_PREFILL_COUNT, glStreamState.bufCount);
+    uint16_t commitLength;
+    uint8_t  expectMult;
+    uint32_t now;
     CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
-    /* Initialize the Debug Module */
-    CyFxUVCApplnDebugInit();
+    while (count-- != 0)
+    {
+        status = CyU3PDmaChannelGetBuffer (&glChHandleUVCStream, &dmaBuffer, CYU3P_NO_WAIT);
+        if (status != CY_U3P_SUCCESS)
+        {
+            break;
+        }
 
-    /* Initialize the UVC Application */
-    CyFxUVCApplnInit();
+        now = CyFxUVCTimeUs ();
+        commitLength = CyFxUVCApplnLoadPayload (dmaBuffer.buffer, &expectMult, now);
+        CyFxUVCApplnCleanBuffer (dmaBuffer.buffer, commitLength);
+        CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_FILL, dmaBuffer.buffer, commitLength, 0);
 
-    for (;;)
-    {
-        frameStart = 0;
-        frameIndex = 0;
-        frameOffset = 0;
+        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
+        CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_COMMIT, status, commitLength, 0);
+        CyFxUVCApplnCountCommit (dmaBuffer.buffer, commitLength, status);
+        if (status != CY_U3P_SUCCESS)
+        {
+            break;
+        }
+        CyFxUVCApplnLatencyCommit (now);
+    }
 
-        /* Reset Frame Id in UVC Header */
-        glUVCHeader[1] = CY_FX_UVC_HEADER_DEFAULT_BFH;
+    return status;
+}
 
-        /* Video streamer application. */
-        while (glIsApplnActive)
+/* Fill and commit up to maxCount free stream buffers, for as long as the stream is active. Called
+ * from the DMA consumer callback in the callback producer mode, and by the UVC application thread
+ * each time it is woken up otherwise. Filling every free buffer keeps all buffers queued to the
+ * endpoint. This is run from I-TCM together with the functions it calls for every buffer. */
+static CY_FX_ITCM_CODE CyU3PReturnStatus_t
+CyFxUVCApplnFillBuffers (
+        uint32_t maxCount,
+        uint32_t now)           /* Current time (us), taken by the caller */
+{
+    CyU3PDmaBuffer_t dmaBuffer;
+    uint32_t requestTime;
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+    while ((glStreamMode == CY_FX_UVC_STREAM_ACTIVE) && (maxCount-- != 0))
+    {
+        /* Take the next free buffer. If there is none, the consumer callback signals the next one.
+         * The wait for the buffer then runs from this call to the one that gets the buffer. The
+         * request starts when the caller read the time, or at the end of the previous commit. */
+        requestTime = now;
+        status = CyU3PDmaChannelGetBuffer (&glChHandleUVCStream, &dmaBuffer, CYU3P_NO_WAIT);
+        CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_GET_BUFFER, status,
+                (status == CY_U3P_SUCCESS) ? dmaBuffer.buffer : 0, 0);
+        if (status == CY_U3P_ERROR_TIMEOUT)
         {
-            /* Wait for a free buffer. */
-            status = CyU3PDmaChannelGetBuffer (&glChHandleUVCStream,
-                    &dmaBuffer, CYU3P_WAIT_FOREVER);
-            if (status != CY_U3P_SUCCESS)
+            if (!glStreamState.bufWaiting)
             {
-                break;
+                glStreamState.waitStart  = requestTime;
+                glStreamState.bufWaiting = 1;
             }
+            return CY_U3P_SUCCESS;
+        }
+        if (status != CY_U3P_SUCCESS)
+        {
+            break;
+        }
 
-            /* Check if packet is last packet or first/intermediate packet */
-            if (frameOffset + (CY_FX_UVC_STREAM_BUF_SIZE - CY_FX_UVC_MAX_HEADER) <
-                    glVidFrameLen[frameIndex])
-            {
-                /* Load the video data to the OUT buffer */
-                CyU3PMemCopy ((dmaBuffer.buffer + CY_FX_UVC_MAX_HEADER),
-                        (uint8_t *)&glUVCVidFrames[frameStart + frameOffset],
-                        (CY_FX_UVC_STREAM_BUF_SIZE - CY_FX_UVC_MAX_HEADER));
+        if (glStreamState.bufWaiting)
+        {
+            requestTime = glStreamState.waitStart;
+            glStreamState.bufWaiting = 0;
+        }
 
-                /* Add header with normal frame indication */
-                CyFxUVCAddHeader (dmaBuffer.buffer, CY_FX_UVC_HEADER_FRAME);
+        status = CyFxUVCApplnSendPayload (dmaBuffer.buffer, requestTime, &now);
+        if (status != CY_U3P_SUCCESS)
+        {
+            break;
+        }
+    }
 
-                /* Commit buffer length */
-                CyU3PThreadSleep (3);
-                commitLength = CY_FX_UVC_STREAM_BUF_SIZE;
+    return status;
+}
 
-                if (CyU3PUsbGetSpeed () == CY_U3P_HIGH_SPEED)
-                {
-                    /* If the current mult setting does not match the expected data size, update this in a safe
-                       manner. */
-                    if (CurrentMultVal != CY_FX_EP_ISO_VIDEO_PKTS_COUNT)
-                    {
-                        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyTrue);
-                        CyU3PBusyWait (10);
-                        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                        CyU3PBusyWait (20);
-                        CyFxUvcAppSetMultByEpm (CY_FX_EP_ISO_VIDEO & 0x0F);
-                        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
-                    }
-                    else
-                    {
-                        /* No change to mult setting. Just commit the data. */
-                        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                    }
-                }
-                else
-                {
-                    /* Not Hi-speed operation. Just commit the data. */
-                    status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                }
+#if CY_FX_UVC_FILL_BENCH_COUNT
+/* Measure the CPU time taken to fill a stream buffer: copying the video data and header, and
+ * writing the buffer back from the D-cache. The same build is run with CY_FX_UVC_DCACHE_ENABLE
+ * set and cleared to compare cached and uncached streaming, as the D-cache configuration can
+ * not be changed once the application is running. */
+static void
+CyFxUVCApplnFillBench (
+        void)
+{
+    uint8_t *buffer_p;
+    uint32_t offset = 0, i;
+    uint32_t startTime, elapsed;
+    const uint32_t payload = CY_FX_UVC_STREAM_BUF_SIZE - CY_FX_UVC_MAX_HEADER;
+
+    buffer_p = (uint8_t *)CyU3PDmaBufferAlloc (CY_FX_UVC_STREAM_BUF_SIZE);
+    if (buffer_p == NULL)
+    {
+        CyU3PDebugPrint (4, "Fill benchmark: buffer allocation failed\r\n");
+        return;
+    }
+
+    startTime = CyFxUVCTimeUs ();
+    for (i = 0; i < CY_FX_UVC_FILL_BENCH_COUNT; i++)
+    {
+        CyU3PMemCopy (buffer_p + CY_FX_UVC_MAX_HEADER, (uint8_t *)&glUVCVidFrames[offset], payload);
+        CyU3PMemCopy (buffer_p, (uint8_t *)glUVCHeaderDefault, CY_FX_UVC_MAX_HEADER);
+        CyFxUVCApplnCleanBuffer (buffer_p, CY_FX_UVC_STREAM_BUF_SIZE);
+
+        offset += payload;
+        if (offset + payload > glVidFrameLen[0])
+            offset = 0;
+    }
+    elapsed = CyFxUVCTimeUs () - startTime;
+
+    CyU3PDebugPrint (4, "Fill benchmark (D-cache %s): %d buffers of %d bytes in %d us, %d us / %d cycles per buffer\r\n",
+            (CY_FX_UVC_DCACHE_ENABLE) ? "on" : "off", CY_FX_UVC_FILL_BENCH_COUNT, CY_FX_UVC_STREAM_BUF_SIZE,
+            elapsed, elapsed / CY_FX_UVC_FILL_BENCH_COUNT,
+            (uint32_t)(((uint64_t)elapsed * CY_FX_UVC_CPU_CLK_KHZ) / 1000 / CY_FX_UVC_FILL_BENCH_COUNT));
+
+    CyU3PDmaBufferFree (buffer_p);
+}
+#endif
+
+#if (CY_FX_UVC_TRACE_ENABLE) && (CY_FX_UVC_TRACE_BENCH_COUNT)
+/* Measure the cost of recording one trace event. The benchmark wraps the ring many times, so the
+ * ring is cleared afterwards. */
+static void
+CyFxUVCApplnTraceBench (
+        void)
+{
+    uint32_t startTime, elapsed, i;
+
+    startTime = CyFxUVCTimeUs ();
+    for (i = 0; i < CY_FX_UVC_TRACE_BENCH_COUNT; i++)
+    {
+        CyFxUVCTraceEvent (CY_FX_UVC_TRACE_BENCH, i, 0, 0);
+    }
+    elapsed = CyFxUVCTimeUs () - startTime;
+
+    CyU3PDebugPrint (4, "Trace benchmark: %d events in %d us, %d ns / %d cycles per event\r\n",
+            CY_FX_UVC_TRACE_BENCH_COUNT, elapsed, (elapsed * 1000) / CY_FX_UVC_TRACE_BENCH_COUNT,
+            (uint32_t)(((uint64_t)elapsed * CY_FX_UVC_CPU_CLK_KHZ) / 1000 / CY_FX_UVC_TRACE_BENCH_COUNT));
+
+    CyFxUVCTraceControl (CyTrue, CyTrue);
+}
+#endif
+
+#if CY_FX_UVC_TIME_BENCH_COUNT
+/* Measure the cost of reading the microsecond time. */
+static void
+CyFxUVCApplnTimeBench (
+        void)
+{
+    uint32_t startTime, elapsed, i;
+
+    startTime = CyFxUVCTimeUs ();
+    for (i = 0; i < CY_FX_UVC_TIME_BENCH_COUNT; i++)
+    {
+        CyFxUVCTimeUs ();
+    }
+    elapsed = CyFxUVCTimeUs () - startTime;
+
+    CyU3PDebugPrint (4, "Time benchmark: %d reads in %d us, %d ns / %d cycles per read\r\n",
+            CY_FX_UVC_TIME_BENCH_COUNT, elapsed, (elapsed * 1000) / CY_FX_UVC_TIME_BENCH_COUNT,
+            (uint32_t)(((uint64_t)elapsed * CY_FX_UVC_CPU_CLK_KHZ) / 1000 / CY_FX_UVC_TIME_BENCH_COUNT));
+}
+#endif
+
+/* Print the measurements taken while streaming and clear them for the next stream. */
+static void
+CyFxUVCApplnStreamReport (
+        void)
+{
+    if (glStreamLatency.sampleCount != 0)
+    {
+        CyU3PDebugPrint (4, "Stream latency (%s): %d buffers, event to commit avg %d us, max %d us\r\n",
+                (CY_FX_UVC_PRODUCER_CALLBACK) ? "callback" : "thread", glStreamLatency.sampleCount,
+                glStreamLatency.totalUs / glStreamLatency.sampleCount, glStreamLatency.maxUs);
+        CyU3PDebugPrint (4, "Stream start: first payload %d us after SET_INTERFACE\r\n", glStreamLatency.firstUs);
+        glStreamLatency.sampleCount = 0;
+        glStreamLatency.totalUs  = 0;
+        glStreamLatency.maxUs    = 0;
+    }
+
+    if (glStreamTransition.stopCount != 0)
+    {
+        CyU3PDebugPrint (4, "Stream transitions: %d starts avg %d us max %d us, %d stops avg %d us max %d us, %d channels created\r\n",
+                glStreamTransition.startCount,
+                (glStreamTransition.startCount != 0) ?
+                (glStreamTransition.startUs / glStreamTransition.startCount) : 0,
+                glStreamTransition.startMaxUs, glStreamTransition.stopCount,
+                glStreamTransition.stopUs / glStreamTransition.stopCount,
+                glStreamTransition.stopMaxUs, glStreamTransition.createCount);
+        CyU3PMemSet ((uint8_t *)&glStreamTransition, 0, sizeof (glStreamTransition));
+    }
+
+    if (glStreamState.underrunFrames != 0)
+    {
+        CyU3PDebugPrint (4, "Stream underruns: in %d frames\r\n", glStreamState.underrunFrames);
+        glStreamState.underrunFrames = 0;
+    }
+
+#if (!CY_FX_UVC_PRODUCER_CALLBACK)
+    if (glStreamWakeups != 0)
+    {
+        CyU3PDebugPrint (4, "Stream wakeups: %d buffers in %d wakeups\r\n", glStreamLatency.commitCount,
+                glStreamWakeups);
+        glStreamWakeups = 0;
+    }
+#endif
+
+#if CY_FX_UVC_PROFILE_ENABLE
+    if (glStreamProfile.bufCount != 0)
+    {
+        CyU3PDebugPrint (4, "Stream profile: %d buffers, %d cycles per buffer\r\n", glStreamProfile.bufCount,
+                (uint32_t)(((uint64_t)glStreamProfile.busyUs * CY_FX_UVC_CPU_CLK_KHZ) / 1000 / glStreamProfile.bufCount));
+        glStreamProfile.bufCount  = 0;
+        glStreamProfile.busyUs = 0;
+    }
+#endif
+
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+    {
+        CyFxUVCCpuLoad_t load;
+
+        /* The window ends at most one slot before the stream stopped. */
+        CyFxUVCCpuGetLoad (&load);
+        CyU3PDebugPrint (4, "Stream CPU load: idle %d.%d %%, interrupts %d.%d %% over the last %d ms\r\n",
+                load.idlePermille / 10, load.idlePermille % 10, load.isrPermille / 10, load.isrPermille % 10,
+                load.windowUs / 1000);
+    }
+#endif
+}
+
+/* Stream state machine, run by the UVC application thread for each message:
+ *   IDLE   --COMMIT/START-->  READY   (channel created for the current speed)
+ *   READY  --START-->         ACTIVE
+ *   ACTIVE --STOP/START-->    READY   (a START restarts the stream)
+ *   any    --RELEASE-->       IDLE    (channel destroyed)
+ * A START at a speed that needs a different buffer size re-creates the channel. */
+static void
+CyFxUVCApplnHandleMsg (
+        const CyFxUVCAppMsg_t *msg_p)
+{
+    CyU3PUSBSpeed_t speed;
+    CyU3PReturnStatus_t status;
+
+    CY_FX_UVC_TRACE (CY_FX_UVC_TRACE_MSG, msg_p->type, glStreamMode, 0);
+
+    if ((glStreamMode == CY_FX_UVC_STREAM_ACTIVE) && (msg_p->type != CY_FX_UVC_MSG_COMMIT))
+    {
+        CyFxUVCApplnStop ();
+        glStreamStats.stopCount++;
+        CyFxUVCApplnTransitionDone (msg_p->postTime, &glStreamTransition.stopCount,
+                &glStreamTransition.stopUs, &glStreamTransition.stopMaxUs);
+
+        /* Report the measurements for the stream that has stopped. */
+        CyFxUVCApplnStreamReport ();
+    }
+
+    switch (msg_p->type)
+    {
+        case CY_FX_UVC_MSG_START:
+        case CY_FX_UVC_MSG_COMMIT:
+            if (msg_p->type == CY_FX_UVC_MSG_COMMIT)
+            {
+                /* Take over the header format selected for the stream settings being committed. */
+                glStreamState.headerFormat = glHeaderFormatReq;
+            }
 
-                if (status != CY_U3P_SUCCESS)
+            speed = CyU3PUsbGetSpeed ();
+            if ((glStreamMode == CY_FX_UVC_STREAM_READY) && (CyFxUVCApplnGetBufSize (speed) != glStreamState.bufSize))
+            {
+                CyFxUVCApplnRelease ();
+            }
+
+            if (glStreamMode == CY_FX_UVC_STREAM_IDLE)
+            {
+                /* The channel is created ahead of the SET_INTERFACE request when the host commits the
+                 * stream settings, which keeps the buffer allocation out of the stream start. */
+                if (CyFxUVCApplnCreateChannel (speed) != CY_U3P_SUCCESS)
                 {
                     break;
                 }
+            }
 
-                /* Update the index for video data */
-                frameOffset += (CY_FX_UVC_STREAM_BUF_SIZE - CY_FX_UVC_MAX_HEADER);
+            if ((msg_p->type == CY_FX_UVC_MSG_START) && (glStreamMode == CY_FX_UVC_STREAM_READY))
+            {
+                status = CyFxUVCApplnStart ();
+                if (status == CY_U3P_SUCCESS)
+                {
+                    glStreamStats.startCount++;
+                    CyFxUVCApplnTransitionDone (msg_p->postTime, &glStreamTransition.startCount,
+                            &glStreamTransition.startUs, &glStreamTransition.startMaxUs);
+                }
             }
-            else
+            break;
+
+        case CY_FX_UVC_MSG_RELEASE:
+            if (glStreamMode == CY_FX_UVC_STREAM_READY)
             {
-                /* Last packet of the video frame. Send this data and then reset all counters. */
+                CyFxUVCApplnRelease ();
+            }
 
-                /* Load the video data to the OUT buffer */
-                CyU3PMemCopy (dmaBuffer.buffer + CY_FX_UVC_MAX_HEADER,
-                        (uint8_t *)&glUVCVidFrames[frameStart + frameOffset],
-                        (glVidFrameLen[frameIndex] - frameOffset));
+            /* Status packets queued for the previous host connection are stale. */
+            CyFxUVCStatusFlush ();
+            break;
 
-                /* Commit buffer length */
-                CyU3PThreadSleep (3);
-                commitLength = (glVidFrameLen[frameIndex] - frameOffset)
-                    + CY_FX_UVC_MAX_HEADER;
+        default:
+            break;
+    }
+}
 
-                /* Add the header with End of Frame Indication */
-                CyFxUVCAddHeader (dmaBuffer.buffer, CY_FX_UVC_HEADER_EOF);
+/* Print the start-up stage times recorded so far. */
+static void
+CyFxUVCApplnBootReport (
+        void)
+{
+    static const char *stageNames[CY_FX_UVC_BOOT_STAGE_COUNT] =
+    {
+        "main", "kernel entry", "app define", "thread", "debug init", "usb start", "connect", "set config"
+    };
+    uint32_t stage;
 
-                if (CyU3PUsbGetSpeed () == CY_U3P_HIGH_SPEED)
-                {
-                    /* If the current mult setting does not match the expected data size, update this in a safe
-                       manner. */
-                    if (CurrentMultVal != ((commitLength / 1024) + 1))
-                    {
-                        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyTrue);
-                        CyU3PBusyWait (10);
-                        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                        CyU3PBusyWait (20);
-                        CyFxUvcAppSetMultByEpm (CY_FX_EP_ISO_VIDEO & 0x0F);
-                        CyU3PUsbSetEpNak (CY_FX_EP_ISO_VIDEO, CyFalse);
-                    }
-                    else
-                    {
-                        /* No change to mult setting. Just commit the data. */
-                        status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                    }
-                }
-                else
-                {
-                    /* Not Hi-speed operation. Just commit the data. */
-                    status = CyU3PDmaChannelCommitBuffer (&glChHandleUVCStream, commitLength, 0);
-                }
+    CyU3PDebugPrint (4, "Boot profile (%s):", (CY_FX_UVC_FAST_BOOT) ? "fast" : "normal");
+    for (stage = 0; stage < CY_FX_UVC_BOOT_STAGE_COUNT; stage++)
+    {
+        if ((glBootProfile.stageMask & (1 << stage)) != 0)
+        {
+            CyU3PDebugPrint (4, " %s %d ms,", stageNames[stage], glBootProfile.stageTick[stage]);
+        }
+    }
+    CyU3PDebugPrint (4, "\r\n");
+}
 
-                if (status != CY_U3P_SUCCESS)
-                {
-                    break;
-                }
+/* Entry function for the UVC application thread. */
+void
+UVCAppThread_Entry (
+        uint32_t input)
+{
+    uint32_t bufTotal = 0, bufFree = 0, bufRegions = 0;
+    uint32_t evMask, evFlags;
+    CyFxUVCAppMsg_t msg;
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+    CyU3PReturnStatus_t timeStatus;
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+    CyU3PReturnStatus_t cpuStatus = CY_U3P_ERROR_NOT_STARTED;
+#endif
+#if CY_FX_UVC_TRACE_ENABLE
+    CyU3PReturnStatus_t traceStatus;
+#endif
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+    CyU3PReturnStatus_t profStatus = CY_U3P_ERROR_NOT_STARTED;
+#endif
+
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_THREAD);
+
+    /* Start the microsecond time base, which the trace and the stream measurements use. */
+    timeStatus = CyFxUVCTimeInit ();
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+    /* The idle thread measures the load with the time base, so it can only run on the GPIO timer. */
+    if (timeStatus == CY_U3P_SUCCESS)
+    {
+        cpuStatus = CyFxUVCCpuInit ();
+    }
+#endif
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+    /* The sampling timer runs in the GPIO block set up for the time base. */
+    if (timeStatus == CY_U3P_SUCCESS)
+    {
+        profStatus = CyFxUVCProfInit ();
+    }
+#endif
 
-                /* Reset the Index for the next frame */
-                frameOffset = 0;
-                frameStart += glVidFrameLen[frameIndex];
-                frameIndex++;
+#if CY_FX_UVC_TRACE_ENABLE
+    /* Start the event trace ahead of USB, so that the enumeration is recorded. */
+    traceStatus = CyFxUVCTraceInit ();
+#endif
 
-                /* If all frames are transferred then start from 0 */
-                if (frameIndex >= CY_FX_UVC_MAX_VID_FRAMES)
-                {
-                    frameIndex = 0;
-                    frameStart = 0;
-                }
+#if CY_FX_UVC_FAST_BOOT
+    /* Connect to USB first, so that the host can enumerate the device while the rest is set up. */
+    CyFxUVCApplnInit();
+#endif
+
+    /* Initialize the Debug Module */
+    CyFxUVCApplnDebugInit();
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_DEBUG_INIT);
+
+    if (timeStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Time base GPIO timer start failed, using the system tick, Error code = %d\r\n",
+                timeStatus);
+    }
+#if CY_FX_UVC_TIME_BENCH_COUNT
+    else
+    {
+        CyFxUVCApplnTimeBench ();
+    }
+#endif
+#if CY_FX_UVC_CPU_LOAD_ENABLE
+    if (cpuStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "CPU load accounting not available, Error code = %d\r\n", cpuStatus);
+    }
+#endif
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+    if (profStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "PC sampling profiler not available, Error code = %d\r\n", profStatus);
+    }
+#endif
+
+#if CY_FX_UVC_TRACE_ENABLE
+    if (traceStatus != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Event trace not available: the boot area is used by the buffer heap\r\n");
+    }
+#endif
+
+    /* Report the DMA buffer capacity available to the application. */
+    CyU3PBufGetCapacity (&bufTotal, &bufFree, &bufRegions);
+    CyU3PDebugPrint (4, "Buffer heap: %d bytes in %d region(s), %d bytes free\r\n", bufTotal, bufRegions, bufFree);
+
+#if CY_FX_UVC_FILL_BENCH_COUNT
+    /* Measure the buffer fill cost. Without fast boot, this is done before the device is connected to USB. */
+    CyFxUVCApplnFillBench ();
+#endif
+
+#if (CY_FX_UVC_TRACE_ENABLE) && (CY_FX_UVC_TRACE_BENCH_COUNT)
+    if (traceStatus == CY_U3P_SUCCESS)
+    {
+        CyFxUVCApplnTraceBench ();
+    }
+#endif
+
+#if (!CY_FX_UVC_FAST_BOOT)
+    /* Initialize the UVC Application */
+    CyFxUVCApplnInit();
+#endif
+
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+    /* Start verifying the heaps in the background. The timer wakes this thread through the stream
+     * event, which has been created by CyFxUVCApplnInit. */
+    status = CyU3PTimerCreate (&glMemCheckTimer, CyFxUVCApplnMemCheckTimerCb, 0,
+            CY_FX_UVC_MEM_CHECK_PERIOD, CY_FX_UVC_MEM_CHECK_PERIOD, CYU3P_AUTO_ACTIVATE);
+    if (status != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Memory check timer create failed, Error Code = %d\r\n", status);
+    }
+#endif
+
+    /* Send telemetry records on the telemetry endpoint. The timer wakes this thread through the
+     * stream event. With a period of 0, the timer is only started by CY_FX_RQT_TELEMETRY_CONTROL;
+     * it is given a non-zero interval anyway, which the RTOS requires. */
+    glTelemetryTime = CyFxUVCTimeUs ();
+    status = CyU3PTimerCreate (&glTelemetryTimer, CyFxUVCApplnTelemetryTimerCb, 0,
+            CY_U3P_MAX (CY_FX_UVC_TELEMETRY_PERIOD, 1), CY_U3P_MAX (CY_FX_UVC_TELEMETRY_PERIOD, 1),
+            (CY_FX_UVC_TELEMETRY_PERIOD != 0) ? CYU3P_AUTO_ACTIVATE : CYU3P_NO_ACTIVATE);
+    if (status != CY_U3P_SUCCESS)
+    {
+        CyU3PDebugPrint (4, "Telemetry timer create failed, Error Code = %d\r\n", status);
+    }
+    else
+    {
+        glTelemetryReady = CyTrue;
+    }
+
+    CyFxUVCApplnBootReport ();
+
+    for (;;)
+    {
+        /* Wait for a message from the USB callbacks or, while streaming in the thread producer mode,
+         * for a free stream buffer. */
+        evMask = CY_FX_UVC_STREAM_EVT_MSG | CY_FX_UVC_STREAM_EVT_UNDERRUN | CY_FX_UVC_STREAM_EVT_TELEMETRY |
+            CY_FX_UVC_STREAM_EVT_MEM_CHECK;
+#if (!CY_FX_UVC_PRODUCER_CALLBACK)
+        if (glStreamMode == CY_FX_UVC_STREAM_ACTIVE)
+        {
+            evMask |= CY_FX_UVC_STREAM_EVT_BUF_FREE;
+            glStreamWakeups++;
+            glStreamStats.bufWaitCount++;
+        }
+#endif
+        status = CyU3PEventGet (&glStreamEvent, evMask, CYU3P_EVENT_OR_CLEAR, &evFlags, CYU3P_WAIT_FOREVER);
+        if (status != CY_U3P_SUCCESS)
+        {
+            continue;
+        }
+
+        if ((evFlags & CY_FX_UVC_STREAM_EVT_MSG) != 0)
+        {
+            while (CyFxUVCApplnGetMsg (&msg))
+            {
+                CyFxUVCApplnHandleMsg (&msg);
             }
         }
 
-        /* There is a streamer error. Flag it. */
-        if ((status != CY_U3P_SUCCESS) && (glIsApplnActive))
+        /* Status and telemetry endpoint packets. */
+        if ((evFlags & CY_FX_UVC_STREAM_EVT_UNDERRUN) != 0)
         {
-            CyU3PDebugPrint (4, "UVC video streamer error. Code %d.\r\n", status);
-            CyFxAppErrorHandler (status);
+            CyFxUVCApplnSendStreamError ();
+        }
+        if ((evFlags & CY_FX_UVC_STREAM_EVT_TELEMETRY) != 0)
+        {
+            CyFxUVCApplnSendTelemetry ();
         }
 
-        /* Sleep for sometime as video streamer is idle. */
-        CyU3PThreadSleep (100);
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+        if ((evFlags & CY_FX_UVC_STREAM_EVT_MEM_CHECK) != 0)
+        {
+            CyFxUVCApplnMemCheck ();
+        }
+#endif
 
+#if (!CY_FX_UVC_PRODUCER_CALLBACK)
+        /* Video streamer: fill every free buffer. */
+        status = CyFxUVCApplnFillBuffers (glStreamState.bufCount, CyFxUVCTimeUs ());
+
+        /* There is a streamer error. Flag it. */
+        if ((status != CY_U3P_SUCCESS) && (glStreamMode == CY_FX_UVC_STREAM_ACTIVE))
+        {
+            CY_FX_UVC_LOG (4, "UVC video streamer error. Code %d.\r\n", status);
+            CyFxAppErrorHandler (status);
+        }
+#endif
     } /* End of for(;;) */
 }
 
@@ -798,6 +2466,8 @@ CyFxApplicationDefine (
     void *ptr = NULL;
     uint32_t retThrdCreate = CY_U3P_SUCCESS;
 
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_APP_DEFINE);
+
     /* Allocate the memory for the thread and create the thread */
     ptr = CyU3PMemAlloc (UVC_APP_THREAD_STACK);
     retThrdCreate = CyU3PThreadCreate (&uvcAppThread,   /* UVC Thread structure */
@@ -823,6 +2493,14 @@ CyFxApplicationDefine (
         /* Loop indefinitely */
         while(1);
     }
+
+#if CY_FX_UVC_LOG_DEFERRED
+    /* Create the thread that sends the deferred log messages to the debug UART. */
+    if (CyFxUVCLogInit () != CY_U3P_SUCCESS)
+    {
+        while(1);
+    }
+#endif
 }
 
 /*
@@ -834,6 +2512,8 @@ main (void)
     CyU3PIoMatrixConfig_t io_cfg;
     CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_MAIN);
+
     /* Initialize the device */
     status = CyU3PDeviceInit (NULL);
     if (status != CY_U3P_SUCCESS)
@@ -841,8 +2521,10 @@ main (void)
         goto handle_fatal_error;
     }
 
-    /* Initialize the caches. Enable only the Instruction Cache. */
-    status = CyU3PDeviceCacheControl (CyTrue, CyFalse, CyFalse);
+    /* Initialize the caches. The Instruction Cache is always enabled; the Data Cache and the
+     * cache handling by the DMA APIs are selected by CY_FX_UVC_DCACHE_ENABLE and
+     * CY_FX_UVC_DCACHE_SDK_MAINT. */
+    status = CyU3PDeviceCacheControl (CyTrue, CY_FX_UVC_DCACHE_ENABLE, CY_FX_UVC_DCACHE_SDK_MAINT);
     if (status != CY_U3P_SUCCESS)
     {
         goto handle_fatal_error;
@@ -862,18 +2544,28 @@ main (void)
     io_cfg.useSpi    = CyFalse;
     io_cfg.lppMode   = CY_U3P_IO_MATRIX_LPP_UART_ONLY;
 
-    /* No GPIOs are enabled. */
+    /* Only the complex GPIOs of the microsecond timer and of the profiler sampling timer are enabled. */
     io_cfg.gpioSimpleEn[0]  = 0;
     io_cfg.gpioSimpleEn[1]  = 0;
     io_cfg.gpioComplexEn[0] = 0;
-    io_cfg.gpioComplexEn[1] = 0;
+    io_cfg.gpioComplexEn[1] = (1 << (CY_FX_UVC_TIME_GPIO - 32));
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+    io_cfg.gpioComplexEn[1] |= (1 << (CY_FX_UVC_PROF_GPIO - 32));
+#endif
     status = CyU3PDeviceConfigureIOMatrix (&io_cfg);
     if (status != CY_U3P_SUCCESS)
     {
         goto handle_fatal_error;
     }
 
+#if CY_FX_UVC_MEM_CHECK_ENABLE
+    /* The checks have to be enabled before the heaps are created from CyU3PKernelEntry. */
+    CyU3PMemEnableChecks (CyTrue, CyFxUVCApplnMemCorruptCb);
+    CyU3PBufEnableChecks (CyTrue, CyFxUVCApplnMemCorruptCb);
+#endif
+
     /* This is a non returnable call for initializing the RTOS kernel */
+    CyFxUVCApplnBootMark (CY_FX_UVC_BOOT_KERNEL_ENTRY);
     CyU3PKernelEntry ();
 
     /* Dummy return to make the compiler happy */
@@ -26,6 +26,7 @@
 #include <cyu3externcstart.h>
 #include <cyu3types.h>
 #include <cyu3usbconst.h>
+#include "cyfxtx.h"
 
 /* This header file comprises of the UVC application contants and
  * the video frame configurations */
@@ -33,10 +34,109 @@
 #define UVC_APP_THREAD_STACK           (0x1000)        /* Thread stack size */
 #define UVC_APP_THREAD_PRIORITY        (8)             /* Thread priority */
 
+/* Leak and corruption checks on the driver and buffer heaps. When enabled, the in-use blocks
+ * of both heaps are verified in the background: a timer wakes the UVC application thread, which
+ * checks up to CY_FX_UVC_MEM_CHECK_BLOCKS blocks of each heap every CY_FX_UVC_MEM_CHECK_PERIOD ms. Requires FX3 SDK 1.3.3 or later.
+ * Enabled by the debug build variant, or with make CYFX_MEM_CHECK=1. */
+#ifndef CY_FX_UVC_MEM_CHECK_ENABLE
+#define CY_FX_UVC_MEM_CHECK_ENABLE     (0)
+#endif
+#define CY_FX_UVC_MEM_CHECK_PERIOD     (10)            /* Interval between check runs in ms */
+#define CY_FX_UVC_MEM_CHECK_BLOCKS     (8)             /* Blocks of each heap checked per run */
+
+/* Data cache configuration. When CY_FX_UVC_DCACHE_ENABLE is set, the D-cache is turned on and
+ * the video data copied into the DMA buffers is written back to memory before the buffers are
+ * committed. With CY_FX_UVC_DCACHE_SDK_MAINT set, the cache maintenance is left to the DMA APIs
+ * of the SDK (which always work on the full buffer); otherwise the application cleans only the
+ * bytes that were filled. All buffers accessed by DMA are 32 byte aligned and padded to a multiple
+ * of 32 bytes, so that they never share a cache line with other data. */
+#define CY_FX_UVC_DCACHE_ENABLE        (0)
+#define CY_FX_UVC_DCACHE_SDK_MAINT     (0)
+
+/* Fast boot. When enabled (make CYFX_FAST_BOOT=1), the application thread starts and connects the
+ * USB device first, and only then sets up the debug UART, the memory checks and the fill benchmark.
+ * Errors during the USB start-up can not be printed in this mode. */
+#ifndef CY_FX_UVC_FAST_BOOT
+#define CY_FX_UVC_FAST_BOOT            (0)
+#endif
+
+/* Start-up stages timed by the boot profile. The times are system ticks (ms), which only start
+ * counting once the RTOS kernel is running: the stages up to the kernel entry are recorded as
+ * reached, with a time of 0. */
+#define CY_FX_UVC_BOOT_MAIN            (0)            /* main entered, .bss cleared. */
+#define CY_FX_UVC_BOOT_KERNEL_ENTRY    (1)            /* Device set up, kernel about to be started. */
+#define CY_FX_UVC_BOOT_APP_DEFINE      (2)            /* CyFxApplicationDefine called by the kernel. */
+#define CY_FX_UVC_BOOT_THREAD          (3)            /* UVC application thread running. */
+#define CY_FX_UVC_BOOT_DEBUG_INIT      (4)            /* Debug UART initialized. */
+#define CY_FX_UVC_BOOT_USB_START       (5)            /* CyU3PUsbStart done. */
+#define CY_FX_UVC_BOOT_CONNECT         (6)            /* CyU3PConnectState done. */
+#define CY_FX_UVC_BOOT_SET_CONFIG      (7)            /* First SET_CONFIGURATION received. */
+#define CY_FX_UVC_BOOT_STAGE_COUNT     (8)
+
+/* Number of buffer fills timed at start-up to measure the CPU cost of streaming with the current
+ * cache configuration. 0 skips the measurement; set with make CYFX_FILL_BENCH=<count>. */
+#ifndef CY_FX_UVC_FILL_BENCH_COUNT
+#define CY_FX_UVC_FILL_BENCH_COUNT     (0)
+#endif
+
+/* Streaming profiler: accounts the CPU time spent filling and committing each stream buffer and
+ * prints the average cost per buffer in CPU cycles when the stream stops. Enabled by the profile
+ * build variant (make CYFX_VARIANT=profile). */
+#ifndef CY_FX_UVC_PROFILE_ENABLE
+#define CY_FX_UVC_PROFILE_ENABLE       (0)
+#endif
+
+/* CPU clock frequency set up by CyU3PDeviceInit with the default clock configuration, used to
+ * convert the measured times to CPU cycles. */
+#define CY_FX_UVC_CPU_CLK_KHZ          (192000)
+
+/* Producer mode. With CY_FX_UVC_PRODUCER_CALLBACK set to 0, the UVC application thread waits for
+ * free stream buffers and fills them. When set to 1 (make CYFX_PRODUCER_CALLBACK=1), the DMA consumer
+ * callback refills the freed buffers directly, using a payload plan worked out when the stream is
+ * started, and the thread is not involved in streaming. */
+#ifndef CY_FX_UVC_PRODUCER_CALLBACK
+#define CY_FX_UVC_PRODUCER_CALLBACK    (0)
+#endif
+
+/* Events used to wake up the UVC application thread. */
+#define CY_FX_UVC_STREAM_EVT_BUF_FREE  (1 << 0)       /* A stream buffer has been consumed (thread producer mode). */
+#define CY_FX_UVC_STREAM_EVT_MSG       (1 << 1)       /* A message has been posted to the application queue. */
+#define CY_FX_UVC_STREAM_EVT_UNDERRUN  (1 << 2)       /* The video endpoint had an underrun: send a status packet. */
+#define CY_FX_UVC_STREAM_EVT_TELEMETRY (1 << 3)       /* The telemetry period has elapsed. */
+#define CY_FX_UVC_STREAM_EVT_MEM_CHECK (1 << 4)       /* The memory check period has elapsed. */
+
+/* Messages posted by the USB callbacks to the UVC application thread, which owns the stream state. */
+#define CY_FX_UVC_MSG_START            (1)            /* SET_INTERFACE to a streaming alternate setting. */
+#define CY_FX_UVC_MSG_STOP             (2)            /* SET_INTERFACE to alternate setting 0. */
+#define CY_FX_UVC_MSG_COMMIT           (3)            /* SET_CUR on the VS commit control. */
+#define CY_FX_UVC_MSG_RELEASE          (4)            /* New configuration, bus reset or disconnect. */
+
+/* Number of messages the application queue can hold. */
+#define CY_FX_UVC_MSG_QUEUE_LEN        (8)
+
+/* States of the video stream. */
+#define CY_FX_UVC_STREAM_IDLE          (0)            /* No stream channel. */
+#define CY_FX_UVC_STREAM_READY         (1)            /* Stream channel created, not streaming. */
+#define CY_FX_UVC_STREAM_ACTIVE        (2)            /* Streaming. */
+
+/* Number of stream buffers filled with the first payloads of the clip when the stream is started,
+ * before the endpoint starts sending data. Limited to the number of stream buffers. */
+#define CY_FX_UVC_STREAM_PREFILL_COUNT (16)
+
+/* Maximum number of payloads in one pass over the video clip (callback producer mode). */
+#define CY_FX_UVC_MAX_PAYLOADS         (32)
+
+/* Number of consumer event times kept for the latency measurement. Has to be a power of 2 that is
+ * larger than the stream buffer count. */
+#define CY_FX_UVC_EVENT_RING_SIZE      (32)
+
 /* Endpoint definition for UVC application */
 #define CY_FX_EP_ISO_VIDEO              0x83           /* EP 3 IN */
 #define CY_FX_EP_VIDEO_CONS_SOCKET      (CY_U3P_UIB_SOCKET_CONS_0 | (CY_FX_EP_ISO_VIDEO & 0x7F)) /* Consumer socket 3 */
 #define CY_FX_EP_CONTROL_STATUS         0x82           /* EP 2 IN */
+#define CY_FX_EP_STATUS_CONS_SOCKET     (CY_U3P_UIB_SOCKET_CONS_0 | (CY_FX_EP_CONTROL_STATUS & 0x7F)) /* Consumer socket 2 */
+#define CY_FX_EP_TELEMETRY              0x84           /* EP 4 IN */
+#define CY_FX_EP_TELEMETRY_CONS_SOCKET  (CY_U3P_UIB_SOCKET_CONS_0 | (CY_FX_EP_TELEMETRY & 0x7F)) /* Consumer socket 4 */
 
 /* UVC descriptor types */
 #define CY_FX_INTF_ASSN_DSCR_TYPE       (11)           /* Interface association descriptor type. */
@@ -49,11 +149,28 @@
 
 #define CY_FX_UVC_MAX_VID_FRAMES       (4)             /* Maximum number of video frames */
 
-/* UVC Buffer size - Will map to ISO Transaction size */
+/* UVC Buffer size for Hi-Speed operation - Will map to ISO Transaction size */
 #define CY_FX_UVC_STREAM_BUF_SIZE      (CY_FX_EP_ISO_VIDEO_PKTS_COUNT * CY_FX_EP_ISO_VIDEO_PKT_SIZE)
 
-/* UVC Buffer count */
-#define CY_FX_UVC_STREAM_BUF_COUNT     (10)
+/* UVC Buffer counts. These are upper limits: the count actually used is reduced to fit the free
+ * space in the buffer heap when the stream is started. */
+#ifdef CYMEM_256K
+#define CY_FX_UVC_STREAM_BUF_COUNT     (6)             /* Hi-Speed buffer count */
+#define CY_FX_UVC_SS_STREAM_BUF_COUNT  (6)             /* Super-Speed buffer count */
+#else
+#define CY_FX_UVC_STREAM_BUF_COUNT     (10)            /* Hi-Speed buffer count */
+#define CY_FX_UVC_SS_STREAM_BUF_COUNT  (16)            /* Super-Speed buffer count */
+#endif
+
+/* Minimum number of buffers required to keep the ISO endpoint fed. */
+#define CY_FX_UVC_STREAM_BUF_COUNT_MIN (3)
+
+/* Space in the buffer heap that is left for other users when sizing the stream buffers. */
+#define CY_FX_UVC_BUF_HEAP_RESERVE     (0x800)
+
+/* Heap space used per buffer on top of its size: rounding to cache lines, the allocator's
+ * terminating cache line and the optional leak check header/footer. */
+#define CY_FX_UVC_BUF_HEAP_OVERHEAD    (96)
 
 /* Low byte - UVC video streaming endpoint packet size */
 #define CY_FX_EP_ISO_VIDEO_PKT_SIZE_L  (uint8_t)(CY_FX_EP_ISO_VIDEO_PKT_SIZE & 0x00FF)
@@ -65,21 +182,35 @@
 /* Mult setting for USB 3.0. Set to 1 for compliance test support. */
 #define CY_FX_EP_ISO_VIDEO_SS_MULT     (1)
 
-/* Burst setting for USB 3.0. Set to burst of 3 KB. */
+/* Burst setting for USB 3.0. Set to burst of 3 KB. The Super-Speed DMA buffer holds one
+ * service interval (PKT_SIZE * BURST * MULT bytes); the payload size in glProbeCtrl has to be
+ * updated if this is changed. */
 #define CY_FX_EP_ISO_VIDEO_SS_BURST    (3)
 
 #define CY_FX_UVC_MAX_HEADER           (12)         /* Maximum number of header bytes in UVC */
 #define CY_FX_UVC_HEADER_DEFAULT_BFH   (0x8C)       /* Default BFH(Bit Field Header) for the UVC Header */
 
+/* UVC payload header formats. The PTS and SCR fields use the microsecond time base (cyfxuvctime.h). */
+#define CY_FX_UVC_HEADER_FMT_MIN       (0)          /* 2 bytes: header length and BFH only. */
+#define CY_FX_UVC_HEADER_FMT_PTS       (1)          /* 6 bytes: with the presentation time stamp. */
+#define CY_FX_UVC_HEADER_FMT_PTS_SCR   (2)          /* 12 bytes: with PTS and source clock reference. */
+#define CY_FX_UVC_HEADER_FMT_COUNT     (3)
+
+/* Header format used until another one is selected with the CY_FX_RQT_SET_HEADER_FORMAT request.
+ * A new selection takes effect when the host next commits the stream settings. */
+#define CY_FX_UVC_HEADER_FORMAT        (CY_FX_UVC_HEADER_FMT_PTS_SCR)
+
 #define CY_FX_UVC_MAX_PROBE_SETTING    (34)         /* Maximum number of bytes in Probe Control */
 #define CY_FX_UVC_MAX_PROBE_SETTING_ALIGNED    (64) /* Maximum number of bytes in Probe Control aligned to 32 byte */
 
 #define CY_FX_UVC_HEADER_FRAME         (0)                    /* Normal frame indication */
 #define CY_FX_UVC_HEADER_EOF           (uint8_t)(1 << 1)      /* End of frame indication */
 #define CY_FX_UVC_HEADER_FRAME_ID      (uint8_t)(1 << 0)      /* Frame ID toggle bit */
+#define CY_FX_UVC_HEADER_ERR           (uint8_t)(1 << 6)      /* Error bit: the stream had an underrun */
 
 #define CY_FX_UVC_INTERFACE_VC          (0)                     /* Video Control interface id. */
 #define CY_FX_UVC_INTERFACE_VS          (1)                     /* Video Streaming interface id. */
+#define CY_FX_UVC_INTERFACE_TELEMETRY   (2)                     /* Vendor specific telemetry interface id. */
 
 #define CY_FX_USB_UVC_SET_REQ_TYPE      (uint8_t)(0x21)         /* UVC interface SET request type */
 #define CY_FX_USB_UVC_GET_REQ_TYPE      (uint8_t)(0xA1)         /* UVC Interface GET request type */
@@ -91,10 +222,171 @@
 
 #define CY_FX_USB_UVC_VS_PROBE_CONTROL  (0x0100)                /* Control selector for VS_PROBE_CONTROL. */
 #define CY_FX_USB_UVC_VS_COMMIT_CONTROL (0x0200)                /* Control selector for VS_COMMIT_CONTROL. */
+#define CY_FX_USB_UVC_VS_STREAM_ERROR_CODE_CONTROL (0x0600)     /* Control selector for VS_STREAM_ERROR_CODE_CONTROL. */
+
+/* bStreamErrorCode values of VS_STREAM_ERROR_CODE_CONTROL. */
+#define CY_FX_UVC_STREAM_ERR_NONE       (0x00)                  /* No error. */
+#define CY_FX_UVC_STREAM_ERR_UNDERRUN   (0x04)                  /* Output buffer underrun. */
 
 #define CY_FX_USB_UVC_VC_RQT_ERROR_CODE_CONTROL (0x0200)
 #define CY_FX_USB_UVC_RQT_STAT_INVALID_CTRL     (0x06)
 
+/* Vendor specific requests (addressed to the device) used to read out diagnostic information. */
+#define CY_FX_USB_VENDOR_GET_REQ_TYPE   (uint8_t)(0xC0)         /* Vendor device-to-host request type */
+#define CY_FX_USB_VENDOR_SET_REQ_TYPE   (uint8_t)(0x40)         /* Vendor host-to-device request type */
+#define CY_FX_RQT_GET_HEAP_STATS        (uint8_t)(0xB0)         /* Read driver and buffer heap statistics. */
+#define CY_FX_RQT_GET_MEM_CHECK         (uint8_t)(0xB1)         /* Read background memory check results. */
+#define CY_FX_RQT_GET_HEAP_BLOCKS       (uint8_t)(0xB2)         /* Read the in-use block list of a heap. */
+#define CY_FX_RQT_GET_BOOT_PROFILE      (uint8_t)(0xB3)         /* Read the start-up stage times. */
+#define CY_FX_RQT_SET_HEADER_FORMAT     (uint8_t)(0xB4)         /* Select the UVC payload header format. */
+#define CY_FX_RQT_GET_STREAM_STATS      (uint8_t)(0xB5)         /* Read the streaming statistics. */
+#define CY_FX_RQT_RESET_STREAM_STATS    (uint8_t)(0xB6)         /* Clear the streaming statistics and histograms. */
+#define CY_FX_RQT_GET_TRACE             (uint8_t)(0xB7)         /* Read the event trace area. */
+#define CY_FX_RQT_TRACE_CONTROL         (uint8_t)(0xB8)         /* Pause, resume or clear the event trace. */
+#define CY_FX_RQT_GET_STAGE_HIST        (uint8_t)(0xB9)         /* Read the per-stage latency histograms. */
+#define CY_FX_RQT_GET_CPU_LOAD          (uint8_t)(0xBA)         /* Read the CPU load over the sliding window. */
+#define CY_FX_RQT_GET_PROFILE           (uint8_t)(0xBB)         /* Read the PC sampling histogram area. */
+#define CY_FX_RQT_PROFILE_CONTROL       (uint8_t)(0xBC)         /* Start, stop or clear the PC sampling. */
+#define CY_FX_RQT_GET_STACK_USAGE       (uint8_t)(0xBD)         /* Read the peak stack usage of every thread. */
+#define CY_FX_RQT_TELEMETRY_CONTROL     (uint8_t)(0xBE)         /* Set the telemetry record interval. */
+
+#define CY_FX_EP0_BUFFER_SIZE           (512)                   /* Size of the EP0 data buffer for vendor requests. */
+
+/* State of the video stream that is updated for every buffer. Kept in D-TCM together with
+ * the UVC header template when D-TCM placement is enabled. */
+typedef struct CyFxUVCStreamState_t
+{
+    uint32_t frameStart;        /* Offset of the current frame in glUVCVidFrames. */
+    uint32_t frameIndex;        /* Index of the current frame. */
+    uint32_t frameOffset;       /* Offset of the next payload data within the current frame. */
+    uint32_t waitStart;         /* Time (us) at which the producer first found no free buffer. */
+    uint16_t bufSize;           /* Size of the stream DMA buffers. */
+    uint16_t bufCount;          /* Number of stream DMA buffers. */
+    uint16_t planIndex;         /* Next entry of the payload plan (callback producer mode). */
+    uint16_t planCount;         /* Number of entries in the payload plan. */
+    uint8_t  headerFormat;      /* Payload header format committed for the stream: CY_FX_UVC_HEADER_FMT_* */
+    uint8_t  headerLen;         /* Length of the payload header in use. */
+    uint8_t  ptsPending;        /* Whether the next payload starts a frame and takes a new PTS. */
+    uint8_t  bufWaiting;        /* Whether the producer is waiting for a free buffer since waitStart. */
+    uint32_t underrunSeen;      /* Endpoint underrun count matched with a consumed payload. */
+    uint16_t frameUnderruns;    /* Underruns while the frame being sent was on the endpoint. */
+    uint16_t underrunFrames;    /* Frames of this stream that were sent with an underrun. */
+    uint32_t payloadCount;      /* Payloads committed in this stream, indexing glPayloadEof. */
+    uint32_t fillFrame;         /* Frames of this stream whose last payload has been filled. */
+    uint32_t wireFrame;         /* Frames of this stream whose last payload has been consumed. */
+    uint32_t errFrame;          /* fillFrame + 1 of the frame to mark with the error bit, or 0. */
+} CyFxUVCStreamState_t;
+
+/* Message sent to the UVC application thread. */
+typedef struct CyFxUVCAppMsg_t
+{
+    uint32_t type;              /* Message type: CY_FX_UVC_MSG_* */
+    uint32_t postTime;          /* Time (us) at which the message was posted. */
+} CyFxUVCAppMsg_t;
+
+/* One payload of the video clip: a slice of a frame that is sent in one stream buffer. */
+typedef struct CyFxUVCPayload_t
+{
+    uint32_t offset;            /* Offset of the payload data in glUVCVidFrames. */
+    uint16_t length;            /* Number of data bytes, excluding the UVC header. */
+    uint8_t  isEof;             /* Whether this is the last payload of a frame. */
+    uint8_t  reserved;
+} CyFxUVCPayload_t;
+
+/* Stream timing: the time from SET_INTERFACE to the first payload sent, and the time from a DMA
+ * consumer event, which frees a stream buffer, to the commit of the refilled buffer. */
+typedef struct CyFxUVCLatency_t
+{
+    uint32_t startTime;         /* Time (us) of the SET_INTERFACE request that started the stream. */
+    uint32_t firstUs;           /* Time from SET_INTERFACE to the first consumer event in us. */
+    uint32_t eventHead;         /* Number of consumer events seen. */
+    uint32_t eventTail;         /* Number of consumer events matched with a commit. */
+    uint32_t commitCount;       /* Number of buffers committed. */
+    uint32_t sampleCount;       /* Number of latency samples taken. */
+    uint32_t totalUs;           /* Sum of the latencies in us. */
+    uint32_t maxUs;             /* Largest latency in us. */
+} CyFxUVCLatency_t;
+
+/* Time taken by the stream start and stop transitions, and the number of stream channels created. */
+typedef struct CyFxUVCTransition_t
+{
+    uint32_t createCount;       /* Number of times the stream DMA channel was created. */
+    uint32_t startCount;        /* Number of stream starts. */
+    uint32_t startUs;           /* Sum of the stream start times in us. */
+    uint32_t startMaxUs;        /* Longest stream start in us. */
+    uint32_t stopCount;         /* Number of stream stops. */
+    uint32_t stopUs;            /* Sum of the stream stop times in us. */
+    uint32_t stopMaxUs;         /* Longest stream stop in us. */
+} CyFxUVCTransition_t;
+
+/* Streaming statistics and latency histograms, counted from power-on or the last
+ * CY_FX_RQT_RESET_STREAM_STATS request.
+ * Unlike the measurements printed when a stream stops, these are never cleared by the firmware. */
+typedef struct CyFxUVCStreamStats_t
+{
+    uint64_t byteCount;         /* Number of bytes committed, including the UVC headers. */
+    uint32_t bufCount;          /* Number of stream buffers committed. */
+    uint32_t frameCount;        /* Number of video frames completed (EOF payloads committed). */
+    uint32_t multChangeCount;   /* Number of changes to the Hi-Speed ISO MULT setting. */
+    uint32_t bufWaitCount;      /* Number of times the producer thread waited for a free buffer. */
+    uint32_t commitFailCount;   /* Number of failed buffer commits. */
+    uint32_t consEventCount;    /* Number of DMA consumer events. */
+    uint32_t startCount;        /* Number of stream starts. */
+    uint32_t stopCount;         /* Number of stream stops. */
+    uint32_t underrunCount;     /* Number of ISO underruns of the video endpoint while streaming. */
+    uint32_t underrunFrames;    /* Number of frames in which an underrun was reported. */
+    uint32_t underrunFrameMax;  /* Largest number of underruns reported in one frame. */
+    uint32_t errPayloadCount;   /* Number of payloads committed with the error bit set. */
+    uint32_t underrunUnmarked;  /* Number of underruns in frames already filled up to their end. */
+} CyFxUVCStreamStats_t;
+
+/* Stages of the per-buffer pipeline that have a latency histogram. */
+#define CY_FX_UVC_STAGE_BUF_WAIT        (0)     /* From asking for a free buffer to getting one. */
+#define CY_FX_UVC_STAGE_FILL            (1)     /* Payload and header copy, and D-cache write back. */
+#define CY_FX_UVC_STAGE_COMMIT          (2)     /* Commit call, including the Hi-Speed MULT update. */
+#define CY_FX_UVC_STAGE_EVENT           (3)     /* Interval between two DMA consumer events. */
+#define CY_FX_UVC_STAGE_SETUP           (4)     /* Standard and class control request, from setup to ack. */
+#define CY_FX_UVC_STAGE_COUNT           (5)
+
+/* Bucket 0 counts samples of 0 us, bucket n samples of 2^(n-1) to 2^n - 1 us, and the last
+ * bucket all samples of 2^(CY_FX_UVC_HIST_BUCKETS - 2) us (16.4 ms) and more. */
+#define CY_FX_UVC_HIST_BUCKETS          (16)
+
+/* Latency histogram of one pipeline stage. */
+typedef struct CyFxUVCHistogram_t
+{
+    uint64_t totalUs;                           /* Sum of the samples in us. */
+    uint32_t maxUs;                             /* Largest sample in us. */
+    uint32_t sampleCount;                       /* Number of samples taken. */
+    uint32_t bucket[CY_FX_UVC_HIST_BUCKETS];    /* Number of samples per bucket. */
+} CyFxUVCHistogram_t;
+
+/* CPU time accounting for the streaming profiler. */
+typedef struct CyFxUVCProfile_t
+{
+    uint32_t bufCount;          /* Number of buffers committed. */
+    uint32_t busyUs;            /* Sum of the time in us spent filling and committing buffers. */
+} CyFxUVCProfile_t;
+
+/* Time at which each start-up stage was reached. */
+typedef struct CyFxUVCBootProfile_t
+{
+    uint32_t stageMask;                                 /* Bit n set: stage n has been reached. */
+    uint32_t stageTick[CY_FX_UVC_BOOT_STAGE_COUNT];     /* Tick count when each stage was reached. */
+} CyFxUVCBootProfile_t;
+
+/* Results of the background memory corruption checks. */
+typedef struct CyFxUVCMemCheckStats_t
+{
+    uint32_t runCount;          /* Number of check runs. */
+    uint32_t memBlocksChecked;  /* Number of driver heap blocks verified. */
+    uint32_t bufBlocksChecked;  /* Number of buffer heap blocks verified. */
+    uint32_t checkFailCount;    /* Number of check runs that found a problem. */
+    uint32_t badBlockCount;     /* Number of corrupted blocks reported by the allocators. */
+    uint32_t lastBadBlock;      /* Address of the last corrupted block reported. */
+    uint32_t bufCheckSkipCount; /* Number of runs that skipped the buffer heap, as its lock was taken. */
+} CyFxUVCMemCheckStats_t;
+
 /* Extern definitions of the USB Enumeration constant arrays used for the Application */
 extern const uint8_t CyFxUSB20DeviceDscr[];
 extern const uint8_t CyFxUSBFSConfigDscr[];
@@ -0,0 +1,175 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvclog.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the deferred binary logging of the UVC application. CyFxUVCLogPrint only
+ * copies the format string address and the argument values into a ring, with interrupts disabled
+ * for the copy. The log thread, which runs below all other threads, empties the ring every
+ * CY_FX_UVC_LOG_DRAIN_PERIOD ms and sends each record to the debug UART as one line:
+ *
+ *   @<time stamp> <format address> <argument> ...
+ *
+ * with all values in hex. When the ring is full, new messages are dropped and counted; the
+ * count is sent as a record with a format address of 0. */
+
+#include <stdarg.h>
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyfxuvclog.h"
+#include "cyfxuvctime.h"
+
+#if CY_FX_UVC_LOG_DEFERRED
+
+static CyU3PThread        glLogThread;                                  /* Log drain thread. */
+static CyFxUVCLogRecord_t glLogRing[CY_FX_UVC_LOG_RING_SIZE];           /* Records not sent yet. */
+static volatile uint32_t  glLogHead    = 0;                             /* Number of records stored. */
+static volatile uint32_t  glLogTail    = 0;                             /* Number of records sent. */
+static volatile uint32_t  glLogDropped = 0;                             /* Records dropped since the last report. */
+
+/* Record formats for each number of arguments. */
+static char *const glLogLineFormat[CY_FX_UVC_LOG_MAX_ARGS + 1] =
+{
+    "@%x %x\r\n",
+    "@%x %x %x\r\n",
+    "@%x %x %x %x\r\n",
+    "@%x %x %x %x %x\r\n",
+    "@%x %x %x %x %x %x\r\n",
+    "@%x %x %x %x %x %x %x\r\n"
+};
+
+CyU3PReturnStatus_t
+CyFxUVCLogPrint (
+        uint8_t  priority,
+        char    *message,
+        ...)
+{
+    CyFxUVCLogRecord_t *rec_p;
+    uint32_t args[CY_FX_UVC_LOG_MAX_ARGS];
+    uint32_t count = 0, posture, i;
+    char *ch_p;
+    va_list argp;
+
+    /* Each conversion in the format takes one 32-bit argument. */
+    va_start (argp, message);
+    for (ch_p = message; (*ch_p != 0) && (count < CY_FX_UVC_LOG_MAX_ARGS); ch_p++)
+    {
+        if (*ch_p == '%')
+        {
+            if (*(++ch_p) == '%')
+                continue;
+            if (*ch_p == 0)
+                break;
+            args[count++] = va_arg (argp, uint32_t);
+        }
+    }
+    va_end (argp);
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    if ((glLogHead - glLogTail) == CY_FX_UVC_LOG_RING_SIZE)
+    {
+        glLogDropped++;
+        tx_interrupt_control (posture);
+        return CY_U3P_ERROR_FAILURE;
+    }
+
+    rec_p = &glLogRing[glLogHead & (CY_FX_UVC_LOG_RING_SIZE - 1)];
+    rec_p->format    = (uint32_t)message;
+    rec_p->timeStamp = CyFxUVCTimeUs ();
+    rec_p->priority  = priority;
+    rec_p->argCount  = (uint8_t)count;
+    for (i = 0; i < count; i++)
+        rec_p->args[i] = args[i];
+    glLogHead++;
+    tx_interrupt_control (posture);
+
+    return CY_U3P_SUCCESS;
+}
+
+/* Send the records in the ring to the debug UART. The record is copied out before the slot is
+ * released to the callers of CyFxUVCLogPrint. */
+static void
+CyFxUVCLogDrain (
+        void)
+{
+    CyFxUVCLogRecord_t rec;
+    uint32_t dropped, posture;
+
+    while (glLogTail != glLogHead)
+    {
+        rec = glLogRing[glLogTail & (CY_FX_UVC_LOG_RING_SIZE - 1)];
+        glLogTail++;
+
+        CyU3PDebugPrint (rec.priority, glLogLineFormat[rec.argCount], rec.timeStamp, rec.format,
+                rec.args[0], rec.args[1], rec.args[2], rec.args[3], rec.args[4]);
+    }
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    dropped = glLogDropped;
+    glLogDropped = 0;
+    tx_interrupt_control (posture);
+
+    if (dropped != 0)
+    {
+        CyU3PDebugPrint (4, glLogLineFormat[1], CyFxUVCTimeUs (), 0, dropped);
+    }
+}
+
+static void
+CyFxUVCLogThread_Entry (
+        uint32_t input)
+{
+    for (;;)
+    {
+        CyU3PThreadSleep (CY_FX_UVC_LOG_DRAIN_PERIOD);
+        CyFxUVCLogDrain ();
+    }
+}
+
+CyU3PReturnStatus_t
+CyFxUVCLogInit (
+        void)
+{
+    void *ptr;
+
+    ptr = CyU3PMemAlloc (CY_FX_UVC_LOG_THREAD_STACK);
+    if (ptr == NULL)
+    {
+        return CY_U3P_ERROR_MEMORY_ERROR;
+    }
+
+    return CyU3PThreadCreate (&glLogThread,             /* Log thread structure */
+            "31:UVC_log_thread",                        /* Thread Id and name */
+            CyFxUVCLogThread_Entry,                     /* Log thread entry function */
+            0,                                          /* No input parameter to thread */
+            ptr,                                        /* Pointer to the allocated thread stack */
+            CY_FX_UVC_LOG_THREAD_STACK,                 /* Log thread stack size */
+            CY_FX_UVC_LOG_THREAD_PRIORITY,              /* Log thread priority */
+            CY_FX_UVC_LOG_THREAD_PRIORITY,              /* Pre-emption threshold */
+            CYU3P_NO_TIME_SLICE,                        /* No time slice for the log thread */
+            CYU3P_AUTO_START                            /* Start the thread immediately */
+            );
+}
+
+#endif
+
+/*[]*/
+
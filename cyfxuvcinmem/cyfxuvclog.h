@@ -0,0 +1,81 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvclog.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCLOG_H_
+#define _INCLUDED_CYFXUVCLOG_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Deferred binary logging. When enabled (make CYFX_DEFERRED_LOG=1), the messages logged with
+ * CY_FX_UVC_LOG are not formatted by the caller. Only the address of the format string and the
+ * argument values are stored in a ring, which a low priority thread sends to the debug UART as
+ * hex encoded records. host/uvclog.py rebuilds the messages from the records and the firmware
+ * ELF file. Otherwise CY_FX_UVC_LOG is CyU3PDebugPrint. */
+#ifndef CY_FX_UVC_LOG_DEFERRED
+#define CY_FX_UVC_LOG_DEFERRED          (0)
+#endif
+
+#define CY_FX_UVC_LOG_RING_SIZE         (64)            /* Records in the ring, a power of 2 */
+#define CY_FX_UVC_LOG_MAX_ARGS          (5)             /* Arguments stored per record */
+#define CY_FX_UVC_LOG_DRAIN_PERIOD      (10)            /* Interval between drain runs in ms */
+#define CY_FX_UVC_LOG_THREAD_STACK      (0x400)         /* Log thread stack size */
+#define CY_FX_UVC_LOG_THREAD_PRIORITY   (15)            /* Log thread priority, below all other threads */
+
+/* One logged message. */
+typedef struct CyFxUVCLogRecord_t
+{
+    uint32_t format;            /* Address of the format string. */
+    uint32_t timeStamp;         /* Time (us) at which the message was logged. */
+    uint8_t  priority;          /* Debug priority, as for CyU3PDebugPrint. */
+    uint8_t  argCount;          /* Number of arguments stored. */
+    uint16_t reserved;
+    uint32_t args[CY_FX_UVC_LOG_MAX_ARGS];
+} CyFxUVCLogRecord_t;
+
+#if CY_FX_UVC_LOG_DEFERRED
+#define CY_FX_UVC_LOG                   CyFxUVCLogPrint
+#else
+#define CY_FX_UVC_LOG                   CyU3PDebugPrint
+#endif
+
+/* Create the log thread. Called from CyFxApplicationDefine. */
+extern CyU3PReturnStatus_t
+CyFxUVCLogInit (
+        void);
+
+/* Store a message in the log ring. Takes the same arguments as CyU3PDebugPrint; the format
+ * string has to be a constant, and %s arguments are only decoded if they point to constant
+ * strings. Only the first CY_FX_UVC_LOG_MAX_ARGS arguments are stored. Returns
+ * CY_U3P_ERROR_FAILURE if the ring is full and the message was dropped. */
+extern CyU3PReturnStatus_t
+CyFxUVCLogPrint (
+        uint8_t  priority,
+        char    *message,
+        ...);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCLOG_H_ */
+
+/*[]*/
+
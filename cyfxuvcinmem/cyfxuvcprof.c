@@ -0,0 +1,186 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvcprof.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the PC sampling profiler of the UVC application (see cyfxuvcprof.h).
+ * The application does not use any other GPIO interrupt, so the GPIO interrupt of the VIC is
+ * given to the profiler; the SDK GPIO interrupt handler is not run. The sample handler clears
+ * the interrupt of the sampling timer in the GPIO block and signals the end of the interrupt to
+ * the VIC itself. The sampling timer runs from the 1 MHz GPIO slow clock set up for the
+ * microsecond time base. */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyu3gpio.h"
+#include "cyu3vic.h"
+#include "cyfxtx.h"
+#include "cyfxuvcprof.h"
+#include "cyfxuvctime.h"
+
+#if CY_FX_UVC_PC_PROFILE_ENABLE
+
+/* VIC and GPIO registers used by the sample handler (FX3 TRM). */
+#define CY_FX_UVC_VIC_VECT_ADDR(n)      (*(uvint32_t *)(0xFFFFF100 + ((n) << 2)))   /* Vector address of interrupt n */
+#define CY_FX_UVC_VIC_ADDRESS           (*(uvint32_t *)(0xFFFFFF00))                /* End of interrupt on write */
+#define CY_FX_UVC_GPIO_PIN_STATUS(pin)  (*(uvint32_t *)(0xE0001100 + (((pin) & 0x07) << 4)))
+#define CY_FX_UVC_GPIO_STATUS_INTR      (0x08000000)    /* Interrupt pending, cleared by writing 1 */
+
+static CyFxUVCProfHeader_t *glProfHeader_p = NULL;      /* Header of the histogram area. */
+static uint32_t            *glProfBins_p   = NULL;      /* Histogram bins. */
+
+CY_FX_ITCM_CODE void
+CyFxUVCProfSample (
+        uint32_t pc)
+{
+    CyFxUVCProfHeader_t *header_p = glProfHeader_p;
+
+    header_p->sampleCount++;
+    if (pc < CY_FX_UVC_PROF_ITCM_SIZE)
+    {
+        glProfBins_p[pc >> CY_FX_UVC_PROF_BIN_SHIFT]++;
+    }
+    else if (((pc - CY_FX_UVC_PROF_SYSMEM_BASE) >> CY_FX_UVC_PROF_BIN_SHIFT) < header_p->sysMemBins)
+    {
+        glProfBins_p[header_p->itcmBins + ((pc - CY_FX_UVC_PROF_SYSMEM_BASE) >> CY_FX_UVC_PROF_BIN_SHIFT)]++;
+    }
+    else
+    {
+        header_p->otherCount++;
+    }
+
+    /* Writing the status back with the interrupt bit set clears it, and keeps the configuration. */
+    CY_FX_UVC_GPIO_PIN_STATUS (CY_FX_UVC_PROF_GPIO) |= CY_FX_UVC_GPIO_STATUS_INTR;
+    CY_FX_UVC_VIC_ADDRESS = 0;
+}
+
+CyU3PReturnStatus_t
+CyFxUVCProfInit (
+        void)
+{
+    uint32_t size;
+    uint8_t *area_p = (uint8_t *)CyU3PBootAreaGet (&size);
+
+    if ((area_p == NULL) || (size < (CY_FX_UVC_PROF_AREA_OFFSET + CY_FX_UVC_PROF_AREA_SIZE)))
+    {
+        return CY_U3P_ERROR_NOT_SUPPORTED;
+    }
+
+    glProfHeader_p = (CyFxUVCProfHeader_t *)(area_p + CY_FX_UVC_PROF_AREA_OFFSET);
+    glProfBins_p   = (uint32_t *)(glProfHeader_p + 1);
+    CyU3PMemSet ((uint8_t *)glProfHeader_p, 0, CY_FX_UVC_PROF_AREA_SIZE);
+
+    glProfHeader_p->binShift   = CY_FX_UVC_PROF_BIN_SHIFT;
+    glProfHeader_p->itcmBins   = CY_FX_UVC_PROF_ITCM_SIZE >> CY_FX_UVC_PROF_BIN_SHIFT;
+    glProfHeader_p->sysMemBase = CY_FX_UVC_PROF_SYSMEM_BASE;
+    glProfHeader_p->sysMemBins = (CY_FX_UVC_PROF_AREA_SIZE - sizeof (CyFxUVCProfHeader_t)) / sizeof (uint32_t) -
+        glProfHeader_p->itcmBins;
+    glProfHeader_p->magic      = CY_FX_UVC_PROF_MAGIC;
+
+    CyU3PVicDisableInt (CY_U3P_VIC_GPIO_CORE_VECTOR);
+    CY_FX_UVC_VIC_VECT_ADDR (CY_U3P_VIC_GPIO_CORE_VECTOR) = (uint32_t)CyFxUVCProfIrqHandler;
+    CyU3PVicEnableInt (CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+    return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t
+CyFxUVCProfControl (
+        CyBool_t enable,
+        CyBool_t clear,
+        uint32_t rateHz)
+{
+    CyU3PGpioComplexConfig_t timerCfg;
+    CyU3PReturnStatus_t status;
+    uint32_t posture;
+
+    if (glProfHeader_p == NULL)
+    {
+        return CY_U3P_ERROR_NOT_STARTED;
+    }
+
+    if (rateHz == 0)
+    {
+        rateHz = CY_FX_UVC_PROF_RATE_HZ;
+    }
+    if (rateHz > CY_FX_UVC_PROF_MAX_RATE_HZ)
+    {
+        return CY_U3P_ERROR_BAD_ARGUMENT;
+    }
+
+    /* Stop the timer first, so that no sample is taken while the histogram is cleared. */
+    CyU3PMemSet ((uint8_t *)&timerCfg, 0, sizeof (timerCfg));
+    timerCfg.pinMode   = CY_U3P_GPIO_MODE_STATIC;
+    timerCfg.intrMode  = CY_U3P_GPIO_NO_INTR;
+    timerCfg.timerMode = CY_U3P_GPIO_TIMER_SHUTDOWN;
+    status = CyU3PGpioSetComplexConfig (CY_FX_UVC_PROF_GPIO, &timerCfg);
+    if ((status != CY_U3P_SUCCESS) || (!enable && !clear))
+    {
+        return status;
+    }
+
+    if (clear)
+    {
+        posture = tx_interrupt_control (TX_INT_DISABLE);
+        glProfHeader_p->sampleCount = 0;
+        glProfHeader_p->otherCount  = 0;
+        CyU3PMemSet ((uint8_t *)glProfBins_p, 0, (glProfHeader_p->itcmBins + glProfHeader_p->sysMemBins) *
+                sizeof (uint32_t));
+        tx_interrupt_control (posture);
+    }
+
+    if (!enable)
+    {
+        return CY_U3P_SUCCESS;
+    }
+
+    /* The timer counts from 0 to the period at 1 MHz and interrupts each time it wraps to 0. */
+    glProfHeader_p->rateHz = rateHz;
+    timerCfg.intrMode  = CY_U3P_GPIO_INTR_TIMER_ZERO;
+    timerCfg.timerMode = CY_U3P_GPIO_TIMER_LOW_FREQ;
+    timerCfg.timer     = 0;
+    timerCfg.period    = (CY_FX_UVC_TIME_CLOCK_HZ / rateHz) - 1;
+    timerCfg.threshold = timerCfg.period;
+    return CyU3PGpioSetComplexConfig (CY_FX_UVC_PROF_GPIO, &timerCfg);
+}
+
+uint16_t
+CyFxUVCProfRead (
+        uint8_t  *buffer_p,
+        uint32_t  offset,
+        uint16_t  maxLength)
+{
+    uint32_t length;
+
+    if ((glProfHeader_p == NULL) || (offset >= CY_FX_UVC_PROF_AREA_SIZE))
+    {
+        return 0;
+    }
+
+    length = CY_U3P_MIN (CY_FX_UVC_PROF_AREA_SIZE - offset, maxLength);
+    CyU3PMemCopy (buffer_p, (uint8_t *)glProfHeader_p + offset, length);
+    return (uint16_t)length;
+}
+
+#endif
+
+/*[]*/
+
@@ -0,0 +1,102 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvcprof.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCPROF_H_
+#define _INCLUDED_CYFXUVCPROF_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Statistical PC sampling profiler (make CYFX_PC_PROFILE=1, GNU toolchain only). The timer of a
+ * second complex GPIO interrupts the CPU at the sampling rate. Its VIC vector is pointed at
+ * CyFxUVCProfIrqHandler (cyfxuvcprof_gcc.S), which passes the interrupted program counter to
+ * CyFxUVCProfSample without going through the RTOS interrupt entry. The sample is counted in a
+ * histogram with one bin for every (1 << CY_FX_UVC_PROF_BIN_SHIFT) bytes of code in the I-TCM
+ * and in the code part of the SYSMEM. The histogram uses the second half of the 2-stage boot
+ * area, after the event trace; host/uvcprof.py maps the bins to functions with the ELF file. */
+#ifndef CY_FX_UVC_PC_PROFILE_ENABLE
+#define CY_FX_UVC_PC_PROFILE_ENABLE     (0)
+#endif
+
+#define CY_FX_UVC_PROF_GPIO             (51)            /* Complex GPIO used for the sampling timer, not used on the board */
+#define CY_FX_UVC_PROF_AREA_OFFSET      (0x4000)        /* Offset of the histogram in the boot area, after the trace */
+#define CY_FX_UVC_PROF_AREA_SIZE        (0x4000)        /* Size of the histogram area */
+#define CY_FX_UVC_PROF_BIN_SHIFT        (6)             /* 64 bytes (16 instructions) of code per bin */
+#define CY_FX_UVC_PROF_ITCM_SIZE        (0x4000)        /* I-TCM code range, from address 0 */
+#define CY_FX_UVC_PROF_SYSMEM_BASE      (0x40003000)    /* Start of the code in the SYSMEM */
+#define CY_FX_UVC_PROF_RATE_HZ          (1000)          /* Default sampling rate */
+#define CY_FX_UVC_PROF_MAX_RATE_HZ      (20000)         /* Highest sampling rate accepted */
+#define CY_FX_UVC_PROF_MAGIC            (0x46525043)    /* "CPRF" */
+
+/* Header at the start of the histogram area, followed by the bins (uint32_t counts). The I-TCM
+ * bins come first, then the SYSMEM bins. */
+typedef struct CyFxUVCProfHeader_t
+{
+    uint32_t magic;             /* CY_FX_UVC_PROF_MAGIC once the area has been set up. */
+    uint32_t rateHz;            /* Sampling rate of the last start. */
+    uint32_t sampleCount;       /* Number of samples taken. */
+    uint32_t otherCount;        /* Samples outside both code ranges. */
+    uint32_t binShift;          /* log2 of the bytes of code per bin. */
+    uint32_t itcmBins;          /* Number of bins for the I-TCM, which starts at address 0. */
+    uint32_t sysMemBase;        /* Address of the first SYSMEM bin. */
+    uint32_t sysMemBins;        /* Number of bins for the SYSMEM. */
+} CyFxUVCProfHeader_t;
+
+/* Set up the histogram area and the sampling timer, and take over the VIC vector of the GPIO
+ * interrupt. The GPIO block has to be running (CyFxUVCTimeInit). Sampling is stopped until
+ * CyFxUVCProfControl starts it. */
+extern CyU3PReturnStatus_t
+CyFxUVCProfInit (
+        void);
+
+/* Start (enable = CyTrue, at rateHz or the default rate if 0) or stop the sampling timer.
+ * clear empties the histogram first. */
+extern CyU3PReturnStatus_t
+CyFxUVCProfControl (
+        CyBool_t enable,
+        CyBool_t clear,
+        uint32_t rateHz);
+
+/* Copy up to maxLength bytes of the histogram area, starting at offset. Returns the number of
+ * bytes copied. */
+extern uint16_t
+CyFxUVCProfRead (
+        uint8_t  *buffer_p,
+        uint32_t  offset,
+        uint16_t  maxLength);
+
+/* Record one sample. Called by CyFxUVCProfIrqHandler in IRQ mode with interrupts disabled. */
+extern void
+CyFxUVCProfSample (
+        uint32_t pc);
+
+/* IRQ handler of the sampling timer (cyfxuvcprof_gcc.S). */
+extern void
+CyFxUVCProfIrqHandler (
+        void);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCPROF_H_ */
+
+/*[]*/
+
@@ -0,0 +1,101 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvcstack.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the thread stack usage report of the UVC application (see
+ * cyfxuvcstack.h). The list of threads is copied with interrupts disabled, and the stacks are
+ * scanned afterwards, so that interrupts are not held off for the length of the scan. The
+ * application does not delete threads, so the stacks stay valid during the scan. */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyfxtx.h"
+#include "cyfxuvcstack.h"
+
+#if CY_FX_UVC_STACK_USAGE_ENABLE
+
+/* Count the bytes at the start of a stack that still hold the fill pattern. */
+static uint32_t
+CyFxUVCStackUnused (
+        uint32_t *start_p,
+        uint32_t  size)
+{
+    uint32_t i;
+
+    for (i = 0; i < (size >> 2); i++)
+    {
+        if (start_p[i] != CYFXTX_MEM_FILL_PATTERN)
+            break;
+    }
+
+    return (i << 2);
+}
+
+uint32_t
+CyFxUVCStackGetUsage (
+        CyFxUVCStackUsage_t *usage_p,
+        uint32_t             maxCount)
+{
+    CyU3PThread *thread[CY_FX_UVC_STACK_MAX_THREADS];
+    uint32_t    *stackStart[CY_FX_UVC_STACK_MAX_THREADS];
+    CyU3PThread *first_p = CyU3PThreadIdentify ();
+    CyU3PThread *thread_p = first_p;
+    const char  *name_p;
+    uint32_t posture, count = 0, i, j;
+
+    if (maxCount > CY_FX_UVC_STACK_MAX_THREADS)
+    {
+        maxCount = CY_FX_UVC_STACK_MAX_THREADS;
+    }
+    CyU3PMemSet ((uint8_t *)usage_p, 0, maxCount * sizeof (CyFxUVCStackUsage_t));
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    while ((thread_p != NULL) && (count < maxCount))
+    {
+        thread[count]              = thread_p;
+        stackStart[count]          = (uint32_t *)thread_p->tx_thread_stack_start;
+        usage_p[count].stackSize   = thread_p->tx_thread_stack_size;
+        usage_p[count].currentUsed = (uint32_t)thread_p->tx_thread_stack_end -
+            (uint32_t)thread_p->tx_thread_stack_ptr + 1;
+        count++;
+
+        thread_p = thread_p->tx_thread_created_next;
+        if (thread_p == first_p)
+            break;
+    }
+    tx_interrupt_control (posture);
+
+    for (i = 0; i < count; i++)
+    {
+        usage_p[i].peakUsed = usage_p[i].stackSize - CyFxUVCStackUnused (stackStart[i], usage_p[i].stackSize);
+        name_p = thread[i]->tx_thread_name;
+        for (j = 0; (name_p != NULL) && (name_p[j] != 0) && (j < CY_FX_UVC_STACK_NAME_SIZE - 1); j++)
+            usage_p[i].name[j] = name_p[j];
+    }
+
+    return count;
+}
+
+#endif
+
+/*[]*/
+
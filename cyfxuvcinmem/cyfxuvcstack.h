@@ -0,0 +1,67 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvcstack.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCSTACK_H_
+#define _INCLUDED_CYFXUVCSTACK_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Thread stack usage. All thread stacks, those of the SDK drivers included, are allocated with
+ * CyU3PMemAlloc, which fills every block with CYFXTX_MEM_FILL_PATTERN (cyfxtx.h) when built with
+ * CYFXTX_MEM_FILL. A stack grows
+ * down from its end, so the words at the start of the stack that still hold the pattern have
+ * never been used, and the rest of the stack is the peak usage since the thread was created.
+ * The IRQ, FIQ and SVC mode stacks set up by the start-up code are not thread stacks, and are
+ * not reported.
+ * The report and the fill are enabled together by the debug build variant, or with make
+ * CYFX_STACK_USAGE=1. */
+#ifndef CY_FX_UVC_STACK_USAGE_ENABLE
+#define CY_FX_UVC_STACK_USAGE_ENABLE    (0)
+#endif
+
+#define CY_FX_UVC_STACK_MAX_THREADS     (16)            /* Threads reported, in creation order */
+#define CY_FX_UVC_STACK_NAME_SIZE       (20)            /* Bytes of the thread name reported */
+
+/* Stack usage of one thread, read by the CY_FX_RQT_GET_STACK_USAGE request. */
+typedef struct CyFxUVCStackUsage_t
+{
+    char     name[CY_FX_UVC_STACK_NAME_SIZE];   /* Start of the thread name, NUL terminated. */
+    uint32_t stackSize;                         /* Size of the stack in bytes. */
+    uint32_t peakUsed;                          /* Bytes used at the deepest point so far. */
+    uint32_t currentUsed;                       /* Bytes in use when the thread was last switched out. */
+} CyFxUVCStackUsage_t;
+
+/* Fill usage_p with up to maxCount entries, one for each ThreadX thread. Returns the number of
+ * entries filled. The stacks are scanned with interrupts enabled, so the figures of the calling
+ * thread and of threads that run meanwhile may be slightly behind. */
+extern uint32_t
+CyFxUVCStackGetUsage (
+        CyFxUVCStackUsage_t *usage_p,
+        uint32_t             maxCount);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCSTACK_H_ */
+
+/*[]*/
+
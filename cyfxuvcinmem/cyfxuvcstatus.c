@@ -0,0 +1,149 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvcstatus.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the interrupt endpoint channels of the UVC application (see cyfxuvcstatus.h).
+ * The channels have no DMA callback: a buffer goes back to the producer once the host has read it,
+ * and CyFxUVCStatusSend only takes a buffer that is already free. Packets are sent and flushed by
+ * the UVC application thread only. */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3dma.h"
+#include "cyu3error.h"
+#include "cyu3usb.h"
+#include "cyfxuvcinmem.h"
+#include "cyfxuvcstatus.h"
+
+/* Endpoint, consumer socket and longest packet of each channel. */
+static const uint8_t  glStatusEp[CY_FX_UVC_STATUS_CH_COUNT] =
+{
+    CY_FX_EP_CONTROL_STATUS, CY_FX_EP_TELEMETRY
+};
+static const uint16_t glStatusSocket[CY_FX_UVC_STATUS_CH_COUNT] =
+{
+    CY_FX_EP_STATUS_CONS_SOCKET, CY_FX_EP_TELEMETRY_CONS_SOCKET
+};
+static const uint16_t glStatusMaxLength[CY_FX_UVC_STATUS_CH_COUNT] =
+{
+    CY_FX_UVC_STATUS_VC_MAX_PACKET, CY_FX_UVC_STATUS_BUF_SIZE
+};
+
+static CyU3PDmaChannel glStatusChannel[CY_FX_UVC_STATUS_CH_COUNT];      /* CPU to endpoint channels. */
+static CyBool_t        glStatusReady[CY_FX_UVC_STATUS_CH_COUNT];        /* Whether each channel exists. */
+static uint32_t        glStatusDropCount = 0;           /* Packets dropped for lack of a free buffer. */
+
+CyU3PReturnStatus_t
+CyFxUVCStatusInit (
+        void)
+{
+    CyU3PDmaChannelConfig_t dmaCfg;
+    CyU3PReturnStatus_t status, result = CY_U3P_SUCCESS;
+    uint8_t channel;
+
+    for (channel = 0; channel < CY_FX_UVC_STATUS_CH_COUNT; channel++)
+    {
+        CyU3PMemSet ((uint8_t *)&dmaCfg, 0, sizeof (dmaCfg));
+        dmaCfg.size = CY_FX_UVC_STATUS_BUF_SIZE;
+        dmaCfg.count = CY_FX_UVC_STATUS_BUF_COUNT;
+        dmaCfg.prodSckId = CY_U3P_CPU_SOCKET_PROD;
+        dmaCfg.consSckId = glStatusSocket[channel];
+        dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
+        dmaCfg.notification = 0;
+        dmaCfg.cb = NULL;
+        status = CyU3PDmaChannelCreate (&glStatusChannel[channel], CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaCfg);
+        if (status == CY_U3P_SUCCESS)
+        {
+            status = CyU3PDmaChannelSetXfer (&glStatusChannel[channel], 0);
+            if (status != CY_U3P_SUCCESS)
+            {
+                CyU3PDmaChannelDestroy (&glStatusChannel[channel]);
+            }
+        }
+
+        glStatusReady[channel] = (status == CY_U3P_SUCCESS);
+        if (result == CY_U3P_SUCCESS)
+        {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+void
+CyFxUVCStatusFlush (
+        void)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < CY_FX_UVC_STATUS_CH_COUNT; channel++)
+    {
+        if (glStatusReady[channel])
+        {
+            CyU3PDmaChannelReset (&glStatusChannel[channel]);
+            CyU3PUsbFlushEp (glStatusEp[channel]);
+            CyU3PDmaChannelSetXfer (&glStatusChannel[channel], 0);
+        }
+    }
+}
+
+CyU3PReturnStatus_t
+CyFxUVCStatusSend (
+        uint8_t        channel,
+        const uint8_t *data_p,
+        uint16_t       length)
+{
+    CyU3PDmaBuffer_t dmaBuffer;
+    CyU3PReturnStatus_t status;
+
+    if ((channel >= CY_FX_UVC_STATUS_CH_COUNT) || (length > glStatusMaxLength[channel]))
+    {
+        return CY_U3P_ERROR_BAD_ARGUMENT;
+    }
+    if (!glStatusReady[channel])
+    {
+        return CY_U3P_ERROR_NOT_STARTED;
+    }
+
+    status = CyU3PDmaChannelGetBuffer (&glStatusChannel[channel], &dmaBuffer, CYU3P_NO_WAIT);
+    if (status != CY_U3P_SUCCESS)
+    {
+        glStatusDropCount++;
+        return status;
+    }
+
+    CyU3PMemCopy (dmaBuffer.buffer, (uint8_t *)data_p, length);
+#if (CY_FX_UVC_DCACHE_ENABLE) && (!CY_FX_UVC_DCACHE_SDK_MAINT)
+    CyU3PSysCleanDRegion ((uint32_t *)dmaBuffer.buffer, (length + 31) & ~31);
+#endif
+
+    return CyU3PDmaChannelCommitBuffer (&glStatusChannel[channel], length, 0);
+}
+
+uint32_t
+CyFxUVCStatusDropCount (
+        void)
+{
+    return glStatusDropCount;
+}
+
+/*[]*/
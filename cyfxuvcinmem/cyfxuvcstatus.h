@@ -0,0 +1,119 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvcstatus.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCSTATUS_H_
+#define _INCLUDED_CYFXUVCSTATUS_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Packets sent on the interrupt endpoints of the application. The CPU writes them into a small
+ * DMA channel per endpoint, and each buffer is sent when the host next polls the endpoint. When
+ * every buffer is still waiting for the host, a new packet is dropped and counted rather than
+ * waited for, so that a host that does not poll the endpoint never holds up the firmware. Packets
+ * still queued on a bus reset or a new configuration are discarded.
+ *
+ * There are two channels:
+ *  - CY_FX_UVC_STATUS_CH_VC feeds the UVC status endpoint (CY_FX_EP_CONTROL_STATUS), which the
+ *    UVC driver of the host reads. It carries the VideoStreaming status packets reporting stream
+ *    errors. The Linux uvcvideo driver reads it into a 16 byte buffer: a longer packet fails that
+ *    transfer with an overflow, after which the driver stops reading the endpoint. Packets are
+ *    therefore limited to CY_FX_UVC_STATUS_VC_MAX_PACKET bytes.
+ *  - CY_FX_UVC_STATUS_CH_TELEMETRY feeds the endpoint of the vendor specific telemetry interface
+ *    (CY_FX_EP_TELEMETRY), which no host class driver binds to. It carries the telemetry record
+ *    (CyFxUVCTelemetry_t), sent periodically once the host has asked for it. */
+
+#define CY_FX_UVC_STATUS_CH_VC          (0)             /* UVC status endpoint */
+#define CY_FX_UVC_STATUS_CH_TELEMETRY   (1)             /* Telemetry interface endpoint */
+#define CY_FX_UVC_STATUS_CH_COUNT       (2)
+
+#define CY_FX_UVC_STATUS_BUF_SIZE       (64)            /* Buffer size: one packet of the endpoint */
+#define CY_FX_UVC_STATUS_BUF_COUNT      (4)             /* Packets that can wait for the host */
+#define CY_FX_UVC_STATUS_VC_MAX_PACKET  (16)            /* Longest packet on the UVC status endpoint */
+
+/* bStatusType of the status packets. */
+#define CY_FX_UVC_STATUS_TYPE_VC        (0x01)          /* VideoControl interface status */
+#define CY_FX_UVC_STATUS_TYPE_VS        (0x02)          /* VideoStreaming interface status */
+#define CY_FX_UVC_STATUS_TYPE_TELEMETRY (0xFF)          /* Vendor defined telemetry record */
+
+/* bEvent of the VideoStreaming status packet sent for a stream error. bValue carries the
+ * bStreamErrorCode that VS_STREAM_ERROR_CODE_CONTROL returns. */
+#define CY_FX_UVC_STATUS_VS_STREAM_ERROR (0x01)
+
+/* Interval between two telemetry records in ms from start-up. 0 sends none until the host sets an
+ * interval with the CY_FX_RQT_TELEMETRY_CONTROL request, which can also stop them again. */
+#define CY_FX_UVC_TELEMETRY_PERIOD      (0)
+#define CY_FX_UVC_TELEMETRY_VERSION     (1)             /* Layout version of CyFxUVCTelemetry_t */
+#define CY_FX_UVC_TELEMETRY_NO_CPU      (0xFFFFFFFF)    /* cpuIdlePermille when the load is not measured */
+
+/* Periodic telemetry record. The counts are taken over the period since the previous record. */
+typedef struct CyFxUVCTelemetry_t
+{
+    uint8_t  statusType;        /* CY_FX_UVC_STATUS_TYPE_TELEMETRY, marking the record type. */
+    uint8_t  version;           /* CY_FX_UVC_TELEMETRY_VERSION. */
+    uint8_t  streamMode;        /* State of the video stream: CY_FX_UVC_STREAM_*. */
+    uint8_t  reserved;
+    uint32_t sequence;          /* Number of records built before this one. */
+    uint32_t timeUs;            /* Microsecond time base when the record was built. */
+    uint32_t periodUs;          /* Time since the previous record in us. */
+    uint32_t byteCount;         /* Bytes committed to the video endpoint, including the headers. */
+    uint32_t frameCount;        /* Video frames completed. */
+    uint32_t underrunCount;     /* Underruns of the video endpoint. */
+    uint32_t cpuIdlePermille;   /* Idle share over the CPU load window (CYFX_CPU_LOAD=1 builds). */
+    uint32_t memUsed;           /* Bytes in use in the driver heap. */
+    uint32_t memLargestFree;    /* Largest free block of the driver heap. */
+    uint32_t bufUsed;           /* Bytes in use in the buffer heap. */
+    uint32_t bufLargestFree;    /* Largest free block of the buffer heap. */
+    uint32_t dropCount;         /* Status packets dropped since power-on. */
+} CyFxUVCTelemetry_t;
+
+/* Create the DMA channels of both endpoints. Called once the endpoints have been configured. A
+ * channel that fails to be created only disables the packets sent on it. */
+extern CyU3PReturnStatus_t
+CyFxUVCStatusInit (
+        void);
+
+/* Discard the packets that have not been sent yet on both endpoints. */
+extern void
+CyFxUVCStatusFlush (
+        void);
+
+/* Queue a packet on the endpoint of a channel: up to CY_FX_UVC_STATUS_VC_MAX_PACKET bytes on the
+ * UVC status endpoint, or CY_FX_UVC_STATUS_BUF_SIZE bytes on the telemetry endpoint. Does not
+ * wait: if no buffer is free, the packet is counted as dropped and the error status is returned. */
+extern CyU3PReturnStatus_t
+CyFxUVCStatusSend (
+        uint8_t        channel,
+        const uint8_t *data_p,
+        uint16_t       length);
+
+/* Number of packets dropped on both channels since power-on. */
+extern uint32_t
+CyFxUVCStatusDropCount (
+        void);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCSTATUS_H_ */
+
+/*[]*/
+
@@ -0,0 +1,98 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvctime.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the microsecond time base of the UVC application (see cyfxuvctime.h).
+ * The GPIO timer runs in the slow clock domain of the GPIO block. Its value is read by sampling
+ * it into the threshold register with CyU3PGpioComplexSampleNow, which waits for the GPIO block
+ * to complete the request. Interrupts are disabled around the sample so that the times returned
+ * follow the order of the calls. */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyu3gpio.h"
+#include "cyfxtx.h"
+#include "cyfxuvctime.h"
+
+static volatile CyBool_t glTimeStarted = CyFalse;       /* Whether the GPIO timer is running. */
+
+CyU3PReturnStatus_t
+CyFxUVCTimeInit (
+        void)
+{
+    CyU3PGpioClock_t gpioClock;
+    CyU3PGpioComplexConfig_t timerCfg;
+    CyU3PReturnStatus_t status;
+
+    gpioClock.fastClkDiv = CY_FX_UVC_TIME_FAST_DIV;
+    gpioClock.slowClkDiv = CY_FX_UVC_TIME_SLOW_DIV;
+    gpioClock.halfDiv    = CyFalse;
+    gpioClock.simpleDiv  = CY_U3P_GPIO_SIMPLE_DIV_BY_2;
+    gpioClock.clkSrc     = CY_U3P_SYS_CLK;
+    status = CyU3PGpioInit (&gpioClock, NULL);
+    if (status != CY_U3P_SUCCESS)
+    {
+        return status;
+    }
+
+    /* Free running timer: the pin is neither driven nor sampled, and the period is the full
+     * 32-bit range. */
+    CyU3PMemSet ((uint8_t *)&timerCfg, 0, sizeof (timerCfg));
+    timerCfg.outValue    = CyFalse;
+    timerCfg.driveLowEn  = CyFalse;
+    timerCfg.driveHighEn = CyFalse;
+    timerCfg.inputEn     = CyFalse;
+    timerCfg.pinMode     = CY_U3P_GPIO_MODE_STATIC;
+    timerCfg.intrMode    = CY_U3P_GPIO_NO_INTR;
+    timerCfg.timerMode   = CY_U3P_GPIO_TIMER_LOW_FREQ;
+    timerCfg.timer       = CyU3PGetTime () * 1000;
+    timerCfg.period      = 0xFFFFFFFF;
+    timerCfg.threshold   = 0xFFFFFFFF;
+    status = CyU3PGpioSetComplexConfig (CY_FX_UVC_TIME_GPIO, &timerCfg);
+    if (status == CY_U3P_SUCCESS)
+    {
+        glTimeStarted = CyTrue;
+    }
+
+    return status;
+}
+
+CY_FX_ITCM_CODE uint32_t
+CyFxUVCTimeUs (
+        void)
+{
+    uint32_t value, posture;
+
+    if (!glTimeStarted)
+    {
+        return CyU3PGetTime () * 1000;
+    }
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    CyU3PGpioComplexSampleNow (CY_FX_UVC_TIME_GPIO, &value);
+    tx_interrupt_control (posture);
+
+    return value;
+}
+
+/*[]*/
+
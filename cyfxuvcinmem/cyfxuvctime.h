@@ -0,0 +1,58 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvctime.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCTIME_H_
+#define _INCLUDED_CYFXUVCTIME_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Microsecond time base. The timer of a complex GPIO runs in pin-less mode from the GPIO slow
+ * clock, which is set to 1 MHz: SYS_CLK (384 MHz with the default clock configuration of
+ * CyU3PDeviceInit) / CY_FX_UVC_TIME_FAST_DIV / CY_FX_UVC_TIME_SLOW_DIV. The timer is never
+ * connected to its pin. The time is a 32-bit count that wraps every 71.6 minutes; intervals are
+ * taken as unsigned differences, which stay correct across the wrap. This is the time base of
+ * the UVC PTS and SCR fields, the trace and log time stamps and the stream measurements. */
+#define CY_FX_UVC_TIME_GPIO             (50)            /* Complex GPIO used for the timer, not used on the board */
+#define CY_FX_UVC_TIME_FAST_DIV         (16)            /* SYS_CLK / 16 = 24 MHz GPIO fast clock */
+#define CY_FX_UVC_TIME_SLOW_DIV         (24)            /* 24 MHz / 24 = 1 MHz GPIO slow clock */
+#define CY_FX_UVC_TIME_CLOCK_HZ         (1000000)       /* Timer frequency, as given in the UVC descriptors */
+#define CY_FX_UVC_TIME_BENCH_COUNT      (1000)          /* Calls timed at start-up, 0 to skip */
+
+/* Set up the GPIO block and start the timer. The timer starts at the current system tick in
+ * microseconds, so that the time does not step back when the timer takes over from the tick. */
+extern CyU3PReturnStatus_t
+CyFxUVCTimeInit (
+        void);
+
+/* Current time in microseconds. Falls back to the system tick (1 ms resolution) until the
+ * timer has been started. */
+extern uint32_t
+CyFxUVCTimeUs (
+        void);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCTIME_H_ */
+
+/*[]*/
+
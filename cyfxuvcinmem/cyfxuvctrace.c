@@ -0,0 +1,230 @@
+/*
+ ## Cypress USB 3.0 Platform source file (cyfxuvctrace.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements the binary event trace of the UVC application. The events are written
+ * into a ring in the RAM area reserved for the 2-stage boot-loader, which is laid out as a
+ * ThreadX trace buffer:
+ *
+ *   CyFxTraceHeader_t                              at the start of the area
+ *   CyFxTraceObject_t [CY_FX_UVC_TRACE_REGISTRY_SIZE]   object registry (thread names)
+ *   CyFxTraceEntry_t  [...]                        event ring, up to the end of the area
+ *
+ * The pointers in the header are the addresses on the device. A host dump of the area can be
+ * opened in TraceX as it is.
+ *
+ * Recording an event is a fixed sequence of stores with interrupts disabled, plus the time stamp.
+ * Reading the time (CyFxUVCTimeUs) polls the GPIO timer until its sample is latched, which takes
+ * 1 to 3 us and dominates the cost of an event; interrupts stay disabled for that long. The time is
+ * read inside the critical section so that the time stamps stay in ring order.
+ *
+ * The thread switches of the kernel itself are not recorded, as the ThreadX library of the SDK is
+ * not built with event trace support; each event shows the thread that recorded it.
+ */
+
+#include "cyu3system.h"
+#include "cyu3os.h"
+#include "cyu3error.h"
+#include "cyu3utils.h"
+#include "cyfxtx.h"
+#include "cyfxuvctrace.h"
+#include "cyfxuvctime.h"
+
+#if CY_FX_UVC_TRACE_ENABLE
+
+static CyFxTraceHeader_t *glTraceHeader_p  = NULL;         /* Start of the trace area. */
+static CyFxTraceEntry_t  *glTraceStart_p   = NULL;         /* First entry of the event ring. */
+static CyFxTraceEntry_t  *glTraceEnd_p     = NULL;         /* End of the event ring. */
+static CyFxTraceEntry_t  *glTraceCurrent_p = NULL;         /* Entry to be written next. */
+static volatile CyBool_t  glTraceEnabled   = CyFalse;      /* Whether events are recorded. */
+
+/* Fill the object registry with the threads that have been created. ThreadX keeps the created
+ * threads in a circular list, which is walked from the calling thread. */
+static void
+CyFxUVCTraceRegisterThreads (
+        void)
+{
+    CyFxTraceObject_t *object_p = (CyFxTraceObject_t *)glTraceHeader_p->registryStart;
+    CyU3PThread *first_p = CyU3PThreadIdentify ();
+    CyU3PThread *thread_p = first_p;
+    uint32_t posture, count = 0, i;
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    while ((thread_p != NULL) && (count < CY_FX_UVC_TRACE_REGISTRY_SIZE))
+    {
+        object_p[count].available = 0;
+        object_p[count].type      = CY_FX_TRACE_OBJECT_TYPE_THREAD;
+        object_p[count].objectPtr = (uint32_t)thread_p;
+        object_p[count].info1     = (uint32_t)thread_p->tx_thread_stack_start;
+        object_p[count].info2     = thread_p->tx_thread_stack_size;
+        for (i = 0; i < CY_FX_TRACE_OBJECT_NAME_SIZE - 1; i++)
+        {
+            object_p[count].name[i] = (thread_p->tx_thread_name != NULL) ? thread_p->tx_thread_name[i] : 0;
+            if (object_p[count].name[i] == 0)
+                break;
+        }
+        object_p[count].name[i] = 0;
+        count++;
+
+        thread_p = thread_p->tx_thread_created_next;
+        if (thread_p == first_p)
+            break;
+    }
+    tx_interrupt_control (posture);
+
+    for (; count < CY_FX_UVC_TRACE_REGISTRY_SIZE; count++)
+    {
+        CyU3PMemSet ((uint8_t *)&object_p[count], 0, sizeof (CyFxTraceObject_t));
+        object_p[count].available = 1;
+    }
+}
+
+CyU3PReturnStatus_t
+CyFxUVCTraceInit (
+        void)
+{
+    uint32_t size;
+    uint8_t *area_p = (uint8_t *)CyU3PBootAreaGet (&size);
+
+    if ((area_p == NULL) || (size < CY_FX_UVC_TRACE_AREA_SIZE))
+    {
+        return CY_U3P_ERROR_NOT_SUPPORTED;
+    }
+
+    CyU3PMemSet (area_p, 0, CY_FX_UVC_TRACE_AREA_SIZE);
+
+    glTraceHeader_p  = (CyFxTraceHeader_t *)area_p;
+    glTraceStart_p   = (CyFxTraceEntry_t *)(area_p + sizeof (CyFxTraceHeader_t) +
+            CY_FX_UVC_TRACE_REGISTRY_SIZE * sizeof (CyFxTraceObject_t));
+    glTraceEnd_p     = glTraceStart_p + (((area_p + CY_FX_UVC_TRACE_AREA_SIZE) - (uint8_t *)glTraceStart_p) /
+            sizeof (CyFxTraceEntry_t));
+    glTraceCurrent_p = glTraceStart_p;
+
+    glTraceHeader_p->timerValidMask   = 0xFFFFFFFF;
+    glTraceHeader_p->traceBase        = (uint32_t)area_p;
+    glTraceHeader_p->registryStart    = (uint32_t)(glTraceHeader_p + 1);
+    glTraceHeader_p->registryNameSize = CY_FX_TRACE_OBJECT_NAME_SIZE;
+    glTraceHeader_p->registryEnd      = (uint32_t)glTraceStart_p;
+    glTraceHeader_p->bufferStart      = (uint32_t)glTraceStart_p;
+    glTraceHeader_p->bufferEnd        = (uint32_t)glTraceEnd_p;
+    glTraceHeader_p->bufferCurrent    = (uint32_t)glTraceCurrent_p;
+    CyFxUVCTraceRegisterThreads ();
+    glTraceHeader_p->traceId          = CY_FX_TRACE_VALID;
+
+    glTraceEnabled = CyTrue;
+    return CY_U3P_SUCCESS;
+}
+
+CY_FX_ITCM_CODE void
+CyFxUVCTraceEvent (
+        uint32_t eventId,
+        uint32_t info1,
+        uint32_t info2,
+        uint32_t info3)
+{
+    CyU3PThread *thread_p;
+    CyFxTraceEntry_t *entry_p;
+    uint32_t posture;
+
+    if (!glTraceEnabled)
+    {
+        return;
+    }
+
+    thread_p = CyU3PThreadIdentify ();
+
+    posture = tx_interrupt_control (TX_INT_DISABLE);
+    entry_p = glTraceCurrent_p;
+    if (thread_p != NULL)
+    {
+        entry_p->threadPtr      = (uint32_t)thread_p;
+        entry_p->threadPriority = thread_p->tx_thread_priority | (thread_p->tx_thread_preempt_threshold << 16);
+    }
+    else
+    {
+        entry_p->threadPtr      = 0;
+        entry_p->threadPriority = 0;
+    }
+    entry_p->eventId   = eventId;
+    entry_p->timeStamp = CY_FX_UVC_TRACE_TIME ();
+    entry_p->info[0]   = info1;
+    entry_p->info[1]   = info2;
+    entry_p->info[2]   = info3;
+    entry_p->info[3]   = 0;
+
+    if (++entry_p == glTraceEnd_p)
+        entry_p = glTraceStart_p;
+    glTraceCurrent_p = entry_p;
+    glTraceHeader_p->bufferCurrent = (uint32_t)entry_p;
+    tx_interrupt_control (posture);
+}
+
+void
+CyFxUVCTraceControl (
+        CyBool_t enable,
+        CyBool_t clear)
+{
+    uint32_t posture;
+
+    if (glTraceHeader_p == NULL)
+    {
+        return;
+    }
+
+    glTraceEnabled = CyFalse;
+    if (clear)
+    {
+        posture = tx_interrupt_control (TX_INT_DISABLE);
+        CyU3PMemSet ((uint8_t *)glTraceStart_p, 0, (uint8_t *)glTraceEnd_p - (uint8_t *)glTraceStart_p);
+        glTraceCurrent_p = glTraceStart_p;
+        glTraceHeader_p->bufferCurrent = (uint32_t)glTraceStart_p;
+        tx_interrupt_control (posture);
+    }
+    glTraceEnabled = enable;
+}
+
+uint16_t
+CyFxUVCTraceRead (
+        uint8_t  *buffer_p,
+        uint32_t  offset,
+        uint16_t  maxLength)
+{
+    uint32_t length;
+
+    if ((glTraceHeader_p == NULL) || (offset >= CY_FX_UVC_TRACE_AREA_SIZE))
+    {
+        return 0;
+    }
+
+    if (offset == 0)
+    {
+        CyFxUVCTraceRegisterThreads ();
+    }
+
+    length = CY_U3P_MIN (CY_FX_UVC_TRACE_AREA_SIZE - offset, maxLength);
+    CyU3PMemCopy (buffer_p, (uint8_t *)glTraceHeader_p + offset, length);
+    return (uint16_t)length;
+}
+
+#endif
+
+/*[]*/
+
@@ -0,0 +1,142 @@
+/*
+ ## Cypress USB 3.0 Platform header file (cyfxuvctrace.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXUVCTRACE_H_
+#define _INCLUDED_CYFXUVCTRACE_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+
+/* Binary event trace. When enabled (make CYFX_TRACE=1), the streaming path and the USB callbacks
+ * record timestamped events into a ring in the RAM area reserved for the 2-stage boot-loader. The
+ * area is laid out as a ThreadX trace buffer (header, object registry and event entries), so that a
+ * raw dump of it can be opened in TraceX. The ring is read out with the CY_FX_RQT_GET_TRACE vendor
+ * request. It is not available when the boot area is given to the buffer heap. */
+#ifndef CY_FX_UVC_TRACE_ENABLE
+#define CY_FX_UVC_TRACE_ENABLE          (0)
+#endif
+
+#define CY_FX_UVC_TRACE_AREA_SIZE       (0x4000)        /* Part of the boot area used for the trace */
+#define CY_FX_UVC_TRACE_REGISTRY_SIZE   (16)            /* Number of object registry entries */
+#define CY_FX_UVC_TRACE_BENCH_COUNT     (10000)         /* Events timed at start-up, 0 to skip */
+
+/* Time stamp of the trace events, in microseconds (see cyfxuvctime.h). Each read waits for the
+ * GPIO timer sample, 1 to 3 us; the system tick is cheaper but only counts milliseconds. */
+#define CY_FX_UVC_TRACE_TIME()          CyFxUVCTimeUs ()
+
+/* Layout of the ThreadX trace buffer, as read by TraceX. */
+#define CY_FX_TRACE_VALID               (0x54585442)    /* Header ID: "TXTB" */
+#define CY_FX_TRACE_OBJECT_NAME_SIZE    (32)            /* Bytes in a registry entry name */
+#define CY_FX_TRACE_OBJECT_TYPE_THREAD  (1)             /* Registry entry type of a thread */
+#define CY_FX_TRACE_USER_EVENT_START    (4096)          /* First event ID free for the application */
+
+typedef struct CyFxTraceHeader_t
+{
+    uint32_t traceId;           /* CY_FX_TRACE_VALID once the trace has been set up. */
+    uint32_t timerValidMask;    /* Bits of the time stamp that are valid. */
+    uint32_t traceBase;         /* Address of this header, used to translate the pointers below. */
+    uint32_t registryStart;     /* First object registry entry. */
+    uint16_t reserved1;
+    uint16_t registryNameSize;  /* CY_FX_TRACE_OBJECT_NAME_SIZE */
+    uint32_t registryEnd;       /* End of the object registry. */
+    uint32_t bufferStart;       /* First event entry. */
+    uint32_t bufferEnd;         /* End of the event entries. */
+    uint32_t bufferCurrent;     /* Entry to be written next: the oldest entry once the ring wraps. */
+    uint32_t reserved2;
+    uint32_t reserved3;
+    uint32_t reserved4;
+} CyFxTraceHeader_t;
+
+typedef struct CyFxTraceObject_t
+{
+    uint8_t  available;         /* 1 if the entry is free. */
+    uint8_t  type;              /* CY_FX_TRACE_OBJECT_TYPE_* */
+    uint8_t  reserved1;
+    uint8_t  reserved2;
+    uint32_t objectPtr;         /* Address of the object. */
+    uint32_t info1;             /* Threads: stack start. */
+    uint32_t info2;             /* Threads: stack size. */
+    uint8_t  name[CY_FX_TRACE_OBJECT_NAME_SIZE];
+} CyFxTraceObject_t;
+
+typedef struct CyFxTraceEntry_t
+{
+    uint32_t threadPtr;         /* Thread that recorded the event, 0 during initialization. */
+    uint32_t threadPriority;    /* Priority, with the preemption threshold in bits 16 to 31. */
+    uint32_t eventId;           /* Event ID, 0 for an unused entry. */
+    uint32_t timeStamp;         /* CY_FX_UVC_TRACE_TIME () when the event was recorded. */
+    uint32_t info[4];           /* Event specific information. */
+} CyFxTraceEntry_t;
+
+/* Events recorded by the UVC application. */
+#define CY_FX_UVC_TRACE_GET_BUFFER      (CY_FX_TRACE_USER_EVENT_START + 0)  /* status, buffer */
+#define CY_FX_UVC_TRACE_FILL            (CY_FX_TRACE_USER_EVENT_START + 1)  /* buffer, length */
+#define CY_FX_UVC_TRACE_COMMIT          (CY_FX_TRACE_USER_EVENT_START + 2)  /* status, length, MULT */
+#define CY_FX_UVC_TRACE_DMA_CB          (CY_FX_TRACE_USER_EVENT_START + 3)  /* type, event count */
+#define CY_FX_UVC_TRACE_USB_EVENT       (CY_FX_TRACE_USER_EVENT_START + 4)  /* event type, data */
+#define CY_FX_UVC_TRACE_SETUP           (CY_FX_TRACE_USER_EVENT_START + 5)  /* setupdat0, setupdat1 */
+#define CY_FX_UVC_TRACE_MSG             (CY_FX_TRACE_USER_EVENT_START + 6)  /* message, stream mode */
+#define CY_FX_UVC_TRACE_BENCH           (CY_FX_TRACE_USER_EVENT_START + 7)  /* sequence number */
+#define CY_FX_UVC_TRACE_UNDERRUN        (CY_FX_TRACE_USER_EVENT_START + 8)  /* underrun count, USB speed */
+
+#if CY_FX_UVC_TRACE_ENABLE
+#define CY_FX_UVC_TRACE(id,i1,i2,i3)    CyFxUVCTraceEvent ((id), (uint32_t)(i1), (uint32_t)(i2), (uint32_t)(i3))
+#else
+#define CY_FX_UVC_TRACE(id,i1,i2,i3)
+#endif
+
+/* Set up the trace ring in the boot area. Returns CY_U3P_ERROR_NOT_SUPPORTED if the area is
+ * not available. */
+extern CyU3PReturnStatus_t
+CyFxUVCTraceInit (
+        void);
+
+/* Record an event. The entry is written with interrupts disabled, so that the ring stays consistent
+ * when events are recorded from several threads or from interrupt handlers. */
+extern void
+CyFxUVCTraceEvent (
+        uint32_t eventId,
+        uint32_t info1,
+        uint32_t info2,
+        uint32_t info3);
+
+/* Pause or resume the recording. With clear set, the ring is emptied before it is resumed. */
+extern void
+CyFxUVCTraceControl (
+        CyBool_t enable,
+        CyBool_t clear);
+
+/* Copy up to maxLength bytes of the trace area, starting at offset, into buffer_p. Reading
+ * offset 0 first refreshes the thread entries of the object registry. Returns the number of
+ * bytes copied. */
+extern uint16_t
+CyFxUVCTraceRead (
+        uint8_t  *buffer_p,
+        uint32_t  offset,
+        uint16_t  maxLength);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYFXUVCTRACE_H_ */
+
+/*[]*/
+
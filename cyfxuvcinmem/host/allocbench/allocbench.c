@@ -0,0 +1,744 @@
+/*
+ ## Cypress FX3 Host Benchmark Source File (allocbench.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file implements a host benchmark for the driver heap and buffer heap allocators in
+ * cyfxtx.c. The allocator source is compiled unchanged against the host OS layer in hostos.c,
+ * and is driven by synthetic workloads or by replaying heap snapshots captured from a device.
+ * For every run, the latency distribution of each allocator call and the fragmentation of
+ * both heaps are reported.
+ *
+ * Workloads:
+ *   churn : Repeated stream start/stop. Each cycle creates a DMA channel the way the UVC
+ *           application does (buffer count sized from the free buffer heap), briefly uses
+ *           an EP0 buffer, and tears the channel down again. Every fourth cycle replaces
+ *           one of a few long lived control blocks so that the heaps do not stay pristine.
+ *   mixed : Random allocations and frees of log-uniformly distributed sizes with a bounded
+ *           number of live blocks in each heap.
+ *   trace : Replay of a snapshot file read from the device with the CY_FX_RQT_GET_HEAP_BLOCKS
+ *           vendor request (see host/uvcdiag.py). Blocks that disappear between snapshots
+ *           are freed and new blocks are allocated in allocation id order.
+ *
+ * Each workload is run with the memory leak and corruption checks disabled and enabled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <cyu3os.h>
+#include <cyu3utils.h>
+#include "../../cyfxtx.h"
+#include "../../cyfxuvcinmem.h"
+#include "hostos.h"
+
+#ifndef HOST_VARIANT
+#define HOST_VARIANT            "512k"
+#endif
+
+#define BENCH_DEFAULT_OPS       (200000)        /* Default number of allocator calls per run. */
+#define BENCH_SAMPLE_PERIOD     (64)            /* Allocator calls between heap statistics samples. */
+#define BENCH_MIXED_SLOTS       (48)            /* Maximum number of live blocks per heap in the mixed workload. */
+#define BENCH_CTRL_SLOTS        (4)             /* Long lived blocks in the churn workload. */
+#define BENCH_CHANNEL_SIZE      (256)           /* Driver heap use of one DMA channel. */
+#define BENCH_EP0_BUF_SIZE      (512)           /* Size of the transient EP0 buffer. */
+
+/* Size of the check header and footer on the device; allocation sizes in a trace include it.
+ * The buffer heap uses a whole cache line for the header. */
+#define BENCH_MEM_CHECK_SIZE    (24)
+#define BENCH_BUF_CHECK_SIZE    (36)
+
+typedef enum BenchOp_t
+{
+    BENCH_MEM_ALLOC = 0,
+    BENCH_MEM_FREE,
+    BENCH_BUF_ALLOC,
+    BENCH_BUF_FREE,
+    BENCH_NUM_OPS
+} BenchOp_t;
+
+static const char *glOpName[BENCH_NUM_OPS] =
+{
+    "MemAlloc", "MemFree", "BufAlloc", "BufFree"
+};
+
+/* Latency samples of one allocator call. */
+typedef struct BenchLatency_t
+{
+    uint32_t *sample_p;
+    uint32_t  count;
+    uint32_t  size;
+} BenchLatency_t;
+
+/* Worst case fragmentation seen in one heap during a run. */
+typedef struct BenchFrag_t
+{
+    uint32_t minLargestFree;                    /* Smallest value of the largest free block. */
+    uint32_t maxFragments;                      /* Highest number of free fragments. */
+    double   maxFragRatio;                      /* Highest value of 1 - largestFree / freeBytes. */
+    double   sumFragRatio;                      /* For the average fragmentation ratio. */
+    uint32_t samples;
+} BenchFrag_t;
+
+typedef struct BenchRun_t
+{
+    BenchLatency_t lat[BENCH_NUM_OPS];
+    BenchFrag_t    memFrag;
+    BenchFrag_t    bufFrag;
+    uint32_t       opCount;
+    uint32_t       liveBlocks;                  /* Blocks allocated and not yet freed. */
+    uint32_t       corruptCount;
+} BenchRun_t;
+
+/* One in-use block from a trace snapshot. */
+typedef struct BenchTraceRec_t
+{
+    uint32_t snapshot;
+    uint8_t  isBuf;
+    uint32_t allocId;
+    uint32_t allocSize;
+} BenchTraceRec_t;
+
+/* A block allocated during trace replay. */
+typedef struct BenchLive_t
+{
+    uint32_t allocId;
+    void    *mem_p;
+    CyBool_t seen;
+} BenchLive_t;
+
+static BenchRun_t       glRun;
+static BenchTraceRec_t *glTrace_p    = 0;
+static uint32_t         glTraceCount = 0;
+static uint32_t         glTraceSnaps = 0;
+
+static uint32_t
+BenchNow (
+        void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+static void
+BenchAddSample (
+        BenchOp_t op,
+        uint32_t  ns)
+{
+    BenchLatency_t *lat_p = &glRun.lat[op];
+
+    if (lat_p->count == lat_p->size)
+    {
+        lat_p->size     = (lat_p->size == 0) ? 4096 : (lat_p->size * 2);
+        lat_p->sample_p = realloc (lat_p->sample_p, lat_p->size * sizeof (uint32_t));
+        if (lat_p->sample_p == 0)
+        {
+            fprintf (stderr, "Out of memory\n");
+            exit (1);
+        }
+    }
+
+    lat_p->sample_p[lat_p->count++] = ns;
+}
+
+static void
+BenchFragSample (
+        BenchFrag_t     *frag_p,
+        CyFxHeapStats_t *stats_p)
+{
+    uint32_t freeBytes = stats_p->totalSize - stats_p->usedSize;
+    double   ratio     = 0;
+
+    if (freeBytes != 0)
+        ratio = 1.0 - ((double)stats_p->largestFree / freeBytes);
+    if (ratio < 0)
+        ratio = 0;
+
+    if ((frag_p->samples == 0) || (stats_p->largestFree < frag_p->minLargestFree))
+        frag_p->minLargestFree = stats_p->largestFree;
+    if (stats_p->freeFragments > frag_p->maxFragments)
+        frag_p->maxFragments = stats_p->freeFragments;
+    if (ratio > frag_p->maxFragRatio)
+        frag_p->maxFragRatio = ratio;
+    frag_p->sumFragRatio += ratio;
+    frag_p->samples++;
+}
+
+/* Count an allocator call and sample the heap statistics periodically. The statistics calls
+ * are not part of the measured latencies. */
+static void
+BenchTick (
+        void)
+{
+    CyFxHeapStats_t stats;
+
+    if ((++glRun.opCount % BENCH_SAMPLE_PERIOD) != 0)
+        return;
+
+    CyU3PMemGetStats (&stats);
+    BenchFragSample (&glRun.memFrag, &stats);
+    CyU3PBufGetStats (&stats);
+    BenchFragSample (&glRun.bufFrag, &stats);
+}
+
+static void *
+BenchMemAlloc (
+        uint32_t size)
+{
+    uint32_t t0 = BenchNow ();
+    void    *mem_p = CyU3PMemAlloc (size);
+
+    BenchAddSample (BENCH_MEM_ALLOC, BenchNow () - t0);
+    if (mem_p != 0)
+        glRun.liveBlocks++;
+    BenchTick ();
+    return mem_p;
+}
+
+static void
+BenchMemFree (
+        void *mem_p)
+{
+    uint32_t t0;
+
+    if (mem_p == 0)
+        return;
+
+    t0 = BenchNow ();
+    CyU3PMemFree (mem_p);
+    BenchAddSample (BENCH_MEM_FREE, BenchNow () - t0);
+    glRun.liveBlocks--;
+    BenchTick ();
+}
+
+static void *
+BenchBufAlloc (
+        uint32_t size)
+{
+    uint32_t t0 = BenchNow ();
+    void    *mem_p = CyU3PDmaBufferAlloc ((uint16_t)size);
+
+    BenchAddSample (BENCH_BUF_ALLOC, BenchNow () - t0);
+    if (mem_p != 0)
+        glRun.liveBlocks++;
+    BenchTick ();
+    return mem_p;
+}
+
+static void
+BenchBufFree (
+        void *mem_p)
+{
+    uint32_t t0;
+
+    if (mem_p == 0)
+        return;
+
+    t0 = BenchNow ();
+    CyU3PDmaBufferFree (mem_p);
+    BenchAddSample (BENCH_BUF_FREE, BenchNow () - t0);
+    glRun.liveBlocks--;
+    BenchTick ();
+}
+
+/* Random size between lo and hi with a log-uniform distribution. */
+static uint32_t
+BenchRandSize (
+        uint32_t lo,
+        uint32_t hi)
+{
+    uint32_t bits = 0, size;
+
+    while ((lo << (bits + 1)) <= hi)
+        bits++;
+
+    size = lo << (rand () % (bits + 1));
+    size += rand () % size;
+    return (size > hi) ? hi : size;
+}
+
+/* Number of stream buffers the application would use, following CyFxUVCApplnSetBufGeometry. */
+static uint32_t
+BenchStreamBufCount (
+        uint32_t limit,
+        uint32_t size)
+{
+    uint32_t freeSize, count = 0;
+
+    CyU3PBufGetCapacity (0, &freeSize, 0);
+    if (freeSize > CY_FX_UVC_BUF_HEAP_RESERVE)
+        count = (freeSize - CY_FX_UVC_BUF_HEAP_RESERVE) / (size + CY_FX_UVC_BUF_HEAP_OVERHEAD);
+
+    return CY_U3P_MIN (count, limit);
+}
+
+static void
+BenchChurn (
+        uint32_t ops)
+{
+    void    *chan_p, *ep0_p;
+    void    *buf_p[CY_FX_UVC_SS_STREAM_BUF_COUNT];
+    void    *ctrlMem_p[BENCH_CTRL_SLOTS] = { 0 };
+    void    *ctrlBuf_p[BENCH_CTRL_SLOTS] = { 0 };
+    uint32_t cycle = 0, count, size, i;
+
+    while (glRun.opCount < ops)
+    {
+        /* Alternate between Super-Speed and Hi-Speed stream geometry. */
+        if (cycle & 1)
+        {
+            size  = CY_FX_UVC_STREAM_BUF_SIZE;
+            count = BenchStreamBufCount (CY_FX_UVC_STREAM_BUF_COUNT, size);
+        }
+        else
+        {
+            size  = CY_FX_EP_ISO_VIDEO_PKT_SIZE * CY_FX_EP_ISO_VIDEO_SS_BURST * CY_FX_EP_ISO_VIDEO_SS_MULT;
+            count = BenchStreamBufCount (CY_FX_UVC_SS_STREAM_BUF_COUNT, size);
+        }
+
+        chan_p = BenchMemAlloc (BENCH_CHANNEL_SIZE + count * sizeof (uint32_t));
+        for (i = 0; i < count; i++)
+            buf_p[i] = BenchBufAlloc (size);
+
+        ep0_p = BenchBufAlloc (BENCH_EP0_BUF_SIZE);
+        BenchBufFree (ep0_p);
+
+        if ((cycle % 4) == 0)
+        {
+            i = (cycle / 4) % BENCH_CTRL_SLOTS;
+            BenchMemFree (ctrlMem_p[i]);
+            BenchBufFree (ctrlBuf_p[i]);
+            ctrlMem_p[i] = BenchMemAlloc (BenchRandSize (16, 256));
+            ctrlBuf_p[i] = BenchBufAlloc (BenchRandSize (32, 1024));
+        }
+
+        for (i = 0; i < count; i++)
+            BenchBufFree (buf_p[i]);
+        BenchMemFree (chan_p);
+        cycle++;
+    }
+
+    for (i = 0; i < BENCH_CTRL_SLOTS; i++)
+    {
+        BenchMemFree (ctrlMem_p[i]);
+        BenchBufFree (ctrlBuf_p[i]);
+    }
+}
+
+static void
+BenchMixed (
+        uint32_t ops)
+{
+    void    *mem_p[BENCH_MIXED_SLOTS] = { 0 };
+    void    *buf_p[BENCH_MIXED_SLOTS] = { 0 };
+    uint32_t i;
+
+    while (glRun.opCount < ops)
+    {
+        i = rand () % BENCH_MIXED_SLOTS;
+        if (rand () & 1)
+        {
+            if (mem_p[i] != 0)
+            {
+                BenchMemFree (mem_p[i]);
+                mem_p[i] = 0;
+            }
+            else
+                mem_p[i] = BenchMemAlloc (BenchRandSize (8, 2048));
+        }
+        else
+        {
+            if (buf_p[i] != 0)
+            {
+                BenchBufFree (buf_p[i]);
+                buf_p[i] = 0;
+            }
+            else
+                buf_p[i] = BenchBufAlloc (BenchRandSize (32, 12288));
+        }
+    }
+
+    for (i = 0; i < BENCH_MIXED_SLOTS; i++)
+    {
+        BenchMemFree (mem_p[i]);
+        BenchBufFree (buf_p[i]);
+    }
+}
+
+static int
+BenchCompareId (
+        const void *a,
+        const void *b)
+{
+    const BenchTraceRec_t *ra = a, *rb = b;
+
+    if (ra->snapshot != rb->snapshot)
+        return (ra->snapshot < rb->snapshot) ? -1 : 1;
+    if (ra->isBuf != rb->isBuf)
+        return (ra->isBuf < rb->isBuf) ? -1 : 1;
+    if (ra->allocId != rb->allocId)
+        return (ra->allocId < rb->allocId) ? -1 : 1;
+    return 0;
+}
+
+/* Load a snapshot file. Each snapshot starts with a line holding "S"; it is followed by one
+ * line per in-use block: "M <id> <size>" for the driver heap or "B <id> <size>" for the
+ * buffer heap. Anything after the size (such as the block address) and lines starting with
+ * '#' are ignored. */
+static CyBool_t
+BenchLoadTrace (
+        const char *name)
+{
+    FILE           *fp;
+    char            line[256];
+    char            heap;
+    uint32_t        id, size, cap = 0;
+
+    fp = fopen (name, "r");
+    if (fp == 0)
+    {
+        perror (name);
+        return CyFalse;
+    }
+
+    while (fgets (line, sizeof (line), fp) != 0)
+    {
+        if ((line[0] == '#') || (line[0] == '\n'))
+            continue;
+
+        if (line[0] == 'S')
+        {
+            glTraceSnaps++;
+            continue;
+        }
+
+        if ((sscanf (line, "%c %u %u", &heap, &id, &size) != 3) || ((heap != 'M') && (heap != 'B')) ||
+                (glTraceSnaps == 0))
+        {
+            fprintf (stderr, "%s: bad line: %s", name, line);
+            fclose (fp);
+            return CyFalse;
+        }
+
+        if (glTraceCount == cap)
+        {
+            cap = (cap == 0) ? 1024 : (cap * 2);
+            glTrace_p = realloc (glTrace_p, cap * sizeof (BenchTraceRec_t));
+            if (glTrace_p == 0)
+            {
+                fprintf (stderr, "Out of memory\n");
+                exit (1);
+            }
+        }
+
+        glTrace_p[glTraceCount].snapshot  = glTraceSnaps - 1;
+        glTrace_p[glTraceCount].isBuf     = (heap == 'B');
+        glTrace_p[glTraceCount].allocId   = id;
+        glTrace_p[glTraceCount].allocSize = size;
+        glTraceCount++;
+    }
+
+    fclose (fp);
+    qsort (glTrace_p, glTraceCount, sizeof (BenchTraceRec_t), BenchCompareId);
+    return CyTrue;
+}
+
+/* Bring the live blocks of one heap in line with the records [first, last) of a snapshot. */
+static void
+BenchReplayHeap (
+        BenchLive_t *live_p,
+        uint32_t    *liveCount_p,
+        uint32_t     first,
+        uint32_t     last,
+        CyBool_t     isBuf)
+{
+    uint32_t i, j, size, hdr;
+
+    for (j = 0; j < *liveCount_p; j++)
+        live_p[j].seen = CyFalse;
+
+    for (i = first; i < last; i++)
+    {
+        for (j = 0; j < *liveCount_p; j++)
+        {
+            if (live_p[j].allocId == glTrace_p[i].allocId)
+            {
+                live_p[j].seen = CyTrue;
+                break;
+            }
+        }
+    }
+
+    /* Free the blocks that were released since the previous snapshot, oldest first. */
+    for (j = 0; j < *liveCount_p; )
+    {
+        if (!live_p[j].seen)
+        {
+            if (isBuf)
+                BenchBufFree (live_p[j].mem_p);
+            else
+                BenchMemFree (live_p[j].mem_p);
+            memmove (&live_p[j], &live_p[j + 1], (*liveCount_p - j - 1) * sizeof (BenchLive_t));
+            (*liveCount_p)--;
+        }
+        else
+            j++;
+    }
+
+    /* Allocate the new blocks in allocation order. */
+    for (i = first; i < last; i++)
+    {
+        for (j = 0; j < *liveCount_p; j++)
+        {
+            if (live_p[j].allocId == glTrace_p[i].allocId)
+                break;
+        }
+        if (j < *liveCount_p)
+            continue;
+
+        size = glTrace_p[i].allocSize;
+        hdr  = (isBuf) ? BENCH_BUF_CHECK_SIZE : BENCH_MEM_CHECK_SIZE;
+        size = (size > hdr) ? (size - hdr) : 4;
+
+        live_p[*liveCount_p].allocId = glTrace_p[i].allocId;
+        live_p[*liveCount_p].mem_p   = (isBuf) ? BenchBufAlloc (size) : BenchMemAlloc (size);
+        live_p[*liveCount_p].seen    = CyTrue;
+        (*liveCount_p)++;
+    }
+}
+
+static void
+BenchTrace (
+        uint32_t ops)
+{
+    BenchLive_t *mem_p, *buf_p;
+    uint32_t     memCount, bufCount;
+    uint32_t     snap, first, mid, last, j;
+
+    mem_p = calloc (glTraceCount + 1, sizeof (BenchLive_t));
+    buf_p = calloc (glTraceCount + 1, sizeof (BenchLive_t));
+    if ((mem_p == 0) || (buf_p == 0))
+    {
+        fprintf (stderr, "Out of memory\n");
+        exit (1);
+    }
+
+    /* Replay the trace until the requested number of calls has been made. */
+    do
+    {
+        memCount = 0;
+        bufCount = 0;
+        first    = 0;
+        for (snap = 0; snap < glTraceSnaps; snap++)
+        {
+            for (mid = first; (mid < glTraceCount) && (glTrace_p[mid].snapshot == snap) && (!glTrace_p[mid].isBuf); mid++)
+                ;
+            for (last = mid; (last < glTraceCount) && (glTrace_p[last].snapshot == snap); last++)
+                ;
+
+            BenchReplayHeap (mem_p, &memCount, first, mid, CyFalse);
+            BenchReplayHeap (buf_p, &bufCount, mid, last, CyTrue);
+            first = last;
+        }
+
+        for (j = 0; j < memCount; j++)
+            BenchMemFree (mem_p[j].mem_p);
+        for (j = 0; j < bufCount; j++)
+            BenchBufFree (buf_p[j].mem_p);
+    } while ((glRun.opCount < ops) && (glTraceCount != 0));
+
+    free (mem_p);
+    free (buf_p);
+}
+
+static int
+BenchCompareU32 (
+        const void *a,
+        const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static uint32_t
+BenchPercentile (
+        BenchLatency_t *lat_p,
+        uint32_t        pct)
+{
+    uint32_t idx;
+
+    if (lat_p->count == 0)
+        return 0;
+
+    idx = (uint32_t)(((uint64_t)lat_p->count * pct) / 100);
+    if (idx >= lat_p->count)
+        idx = lat_p->count - 1;
+    return lat_p->sample_p[idx];
+}
+
+static void
+BenchPrintFrag (
+        const char  *name,
+        BenchFrag_t *frag_p,
+        CyFxHeapStats_t *stats_p)
+{
+    printf ("  %-4s heap: size %6u  peak %6u  min largest free %6u  max fragments %4u"
+            "  frag avg %4.1f%% max %4.1f%%  alloc failures %u\n",
+            name, stats_p->totalSize, stats_p->peakUsedSize, frag_p->minLargestFree, frag_p->maxFragments,
+            (frag_p->samples != 0) ? (100.0 * frag_p->sumFragRatio / frag_p->samples) : 0.0,
+            100.0 * frag_p->maxFragRatio, stats_p->allocFailCount);
+}
+
+static void
+BenchCorruptCb (
+        void *mem_p)
+{
+    (void)mem_p;
+    glRun.corruptCount++;
+}
+
+static void
+BenchRun (
+        const char *workload,
+        void      (*func) (uint32_t ops),
+        uint32_t    ops,
+        CyBool_t    checks,
+        uint32_t    seed)
+{
+    CyFxHeapStats_t memStats, bufStats;
+    uint32_t        i;
+
+    memset (&glRun, 0, sizeof (glRun));
+    srand (seed);
+
+    CyU3PMemEnableChecks (checks, BenchCorruptCb);
+    CyU3PBufEnableChecks (checks, BenchCorruptCb);
+    CyU3PMemInit ();
+    CyU3PDmaBufferInit ();
+
+    func (ops);
+
+    CyU3PMemGetStats (&memStats);
+    CyU3PBufGetStats (&bufStats);
+
+    printf ("%s, checks %s, %u calls\n", workload, (checks) ? "on" : "off", glRun.opCount);
+    printf ("  %-8s %9s %7s %7s %7s %7s %8s  (ns)\n", "call", "count", "p50", "p90", "p99", "p99.9", "max");
+    for (i = 0; i < BENCH_NUM_OPS; i++)
+    {
+        BenchLatency_t *lat_p = &glRun.lat[i];
+        uint32_t        p999;
+
+        qsort (lat_p->sample_p, lat_p->count, sizeof (uint32_t), BenchCompareU32);
+        p999 = (lat_p->count != 0) ? lat_p->sample_p[(uint32_t)(((uint64_t)lat_p->count * 999) / 1000)] : 0;
+        printf ("  %-8s %9u %7u %7u %7u %7u %8u\n", glOpName[i], lat_p->count,
+                BenchPercentile (lat_p, 50), BenchPercentile (lat_p, 90), BenchPercentile (lat_p, 99), p999,
+                (lat_p->count != 0) ? lat_p->sample_p[lat_p->count - 1] : 0);
+        free (lat_p->sample_p);
+    }
+
+    BenchPrintFrag ("mem", &glRun.memFrag, &memStats);
+    BenchPrintFrag ("buf", &glRun.bufFrag, &bufStats);
+
+    /* Everything must have been returned to the heaps at the end of a workload. */
+    if ((glRun.liveBlocks != 0) || (bufStats.usedSize != 0) || (glRun.corruptCount != 0))
+        printf ("  WARNING: %u blocks not freed, %u bytes of buffer heap in use, %u corrupted blocks\n",
+                glRun.liveBlocks, bufStats.usedSize, glRun.corruptCount);
+
+    CyU3PFreeHeaps ();
+}
+
+static void
+BenchUsage (
+        const char *name)
+{
+    fprintf (stderr,
+            "Usage: %s [-n calls] [-s seed] [-t snapshot-file] [workload ...]\n"
+            "  workload : churn, mixed or trace (default: churn mixed, plus trace if -t is given)\n"
+            "  -n       : number of allocator calls per run (default %u)\n"
+            "  -s       : random seed (default 1)\n"
+            "  -t       : snapshot file for the trace workload\n",
+            name, BENCH_DEFAULT_OPS);
+    exit (1);
+}
+
+int
+main (
+        int    argc,
+        char **argv)
+{
+    const char *names[3];
+    uint32_t    ops = BENCH_DEFAULT_OPS, seed = 1, count = 0;
+    const char *traceFile = 0;
+    int         i, checks;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((strcmp (argv[i], "-n") == 0) && (i + 1 < argc))
+            ops = strtoul (argv[++i], 0, 0);
+        else if ((strcmp (argv[i], "-s") == 0) && (i + 1 < argc))
+            seed = strtoul (argv[++i], 0, 0);
+        else if ((strcmp (argv[i], "-t") == 0) && (i + 1 < argc))
+            traceFile = argv[++i];
+        else if ((argv[i][0] != '-') && (count < 3))
+            names[count++] = argv[i];
+        else
+            BenchUsage (argv[0]);
+    }
+
+    if (count == 0)
+    {
+        names[count++] = "churn";
+        names[count++] = "mixed";
+        if (traceFile != 0)
+            names[count++] = "trace";
+    }
+
+    if (!HostMapSysMem ())
+        return 1;
+
+    if ((traceFile != 0) && (!BenchLoadTrace (traceFile)))
+        return 1;
+
+    printf ("cyfxtx.c allocator benchmark, %s memory map\n\n", HOST_VARIANT);
+
+    for (i = 0; i < (int)count; i++)
+    {
+        for (checks = 0; checks < 2; checks++)
+        {
+            if (strcmp (names[i], "churn") == 0)
+                BenchRun (names[i], BenchChurn, ops, checks, seed);
+            else if (strcmp (names[i], "mixed") == 0)
+                BenchRun (names[i], BenchMixed, ops, checks, seed);
+            else if ((strcmp (names[i], "trace") == 0) && (traceFile != 0))
+                BenchRun (names[i], BenchTrace, ops, checks, seed);
+            else
+                BenchUsage (argv[0]);
+            printf ("\n");
+        }
+    }
+
+    return 0;
+}
+
+/*[]*/
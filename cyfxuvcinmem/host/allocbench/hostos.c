@@ -0,0 +1,262 @@
+/*
+ ## Cypress FX3 Host Benchmark Source File (hostos.c)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+/* This file provides the OS services used by cyfxtx.c, so that the allocators can be
+ * built and measured on a host PC. The byte pool follows the ThreadX implementation:
+ * each block starts with a pointer to the next block followed by a pointer sized word
+ * that holds TX_BYTE_BLOCK_FREE for free blocks or the owning pool for allocated ones.
+ * Allocation is first-fit starting at the search pointer, adjacent free blocks are merged
+ * while searching, and a free moves the search pointer to the released block.
+ */
+
+#include <sys/mman.h>
+#include <stdio.h>
+
+#include <cyu3os.h>
+#include "hostos.h"
+
+#define HOST_BLOCK_FREE         (0xFFFFEEEEUL)          /* Marker of a free block. */
+#define HOST_BLOCK_HDR_SIZE     (2 * sizeof (uint8_t *))
+#define HOST_BLOCK_MIN          (20)                    /* Smallest remainder that is split off. */
+
+#define HOST_BLOCK_NEXT(b)      (*((uint8_t **)(b)))
+#define HOST_BLOCK_MARK(b)      (*((uintptr_t *)((b) + sizeof (uint8_t *))))
+
+static CyU3PThread glHostThread = { 1 };                /* The single host "thread". */
+static CyBool_t    glHostIsThread = CyTrue;             /* Whether calls are made in thread context. */
+
+CyBool_t
+HostMapSysMem (
+        void)
+{
+    void *mem_p;
+
+    mem_p = mmap ((void *)HOST_SYS_MEM_BASE, HOST_SYS_MEM_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mem_p != (void *)HOST_SYS_MEM_BASE)
+    {
+        fprintf (stderr, "Failed to map system RAM window at 0x%08x\n", HOST_SYS_MEM_BASE);
+        return CyFalse;
+    }
+
+    return CyTrue;
+}
+
+void
+HostSetThreadContext (
+        CyBool_t isThread)
+{
+    glHostIsThread = isThread;
+}
+
+UINT
+tx_interrupt_control (
+        UINT new_posture)
+{
+    (void)new_posture;
+    return TX_INT_ENABLE;
+}
+
+CyU3PThread *
+CyU3PThreadIdentify (
+        void)
+{
+    return (glHostIsThread) ? &glHostThread : 0;
+}
+
+void
+CyU3PApplicationDefine (
+        void)
+{
+}
+
+uint32_t
+CyU3PMutexCreate (
+        CyU3PMutex *mutex_p,
+        uint32_t    priorityInherit)
+{
+    (void)priorityInherit;
+    mutex_p->ownerCount = 0;
+    mutex_p->created    = CyTrue;
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PMutexDestroy (
+        CyU3PMutex *mutex_p)
+{
+    mutex_p->created = CyFalse;
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PMutexGet (
+        CyU3PMutex *mutex_p,
+        uint32_t    waitOption)
+{
+    (void)waitOption;
+    if (!mutex_p->created)
+        return CY_U3P_ERROR_FAILURE;
+
+    mutex_p->ownerCount++;
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PMutexPut (
+        CyU3PMutex *mutex_p)
+{
+    if ((!mutex_p->created) || (mutex_p->ownerCount == 0))
+    {
+        fprintf (stderr, "Unbalanced mutex put\n");
+        return CY_U3P_ERROR_FAILURE;
+    }
+
+    mutex_p->ownerCount--;
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PBytePoolCreate (
+        CyU3PBytePool *pool_p,
+        void          *poolStart,
+        uint32_t       poolSize)
+{
+    uint8_t *start_p = (uint8_t *)poolStart;
+    uint8_t *end_p;
+
+    poolSize &= ~(uint32_t)(sizeof (uintptr_t) - 1);
+
+    /* One free block covering the pool, followed by a permanently allocated block that
+       links back to the start of the pool. */
+    end_p = start_p + poolSize - HOST_BLOCK_HDR_SIZE;
+    HOST_BLOCK_NEXT (start_p) = end_p;
+    HOST_BLOCK_MARK (start_p) = HOST_BLOCK_FREE;
+    HOST_BLOCK_NEXT (end_p)   = start_p;
+    HOST_BLOCK_MARK (end_p)   = (uintptr_t)pool_p;
+
+    pool_p->tx_byte_pool_start     = start_p;
+    pool_p->tx_byte_pool_size      = poolSize;
+    pool_p->tx_byte_pool_available = poolSize - 2 * HOST_BLOCK_HDR_SIZE;
+    pool_p->tx_byte_pool_fragments = 2;
+    pool_p->tx_byte_pool_search    = start_p;
+
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PBytePoolDestroy (
+        CyU3PBytePool *pool_p)
+{
+    pool_p->tx_byte_pool_start = 0;
+    pool_p->tx_byte_pool_size  = 0;
+    return CY_U3P_SUCCESS;
+}
+
+uint32_t
+CyU3PByteAlloc (
+        CyU3PBytePool *pool_p,
+        void         **mem_p,
+        uint32_t       memSize,
+        uint32_t       waitOption)
+{
+    uint8_t  *block_p, *next_p, *split_p;
+    uint32_t  examine, avail;
+
+    (void)waitOption;
+    *mem_p  = 0;
+    memSize = (memSize + sizeof (uintptr_t) - 1) & ~(uint32_t)(sizeof (uintptr_t) - 1);
+    if ((pool_p->tx_byte_pool_start == 0) || (memSize > pool_p->tx_byte_pool_available))
+        return CY_U3P_ERROR_NO_MEMORY;
+
+    block_p = pool_p->tx_byte_pool_search;
+    examine = pool_p->tx_byte_pool_fragments + 1;
+    while (examine-- != 0)
+    {
+        next_p = HOST_BLOCK_NEXT (block_p);
+        if (HOST_BLOCK_MARK (block_p) == HOST_BLOCK_FREE)
+        {
+            /* Merge the free blocks that follow this one. */
+            while ((next_p != pool_p->tx_byte_pool_start) && (HOST_BLOCK_MARK (next_p) == HOST_BLOCK_FREE))
+            {
+                if (pool_p->tx_byte_pool_search == next_p)
+                    pool_p->tx_byte_pool_search = block_p;
+                next_p = HOST_BLOCK_NEXT (next_p);
+                HOST_BLOCK_NEXT (block_p) = next_p;
+                pool_p->tx_byte_pool_fragments--;
+                pool_p->tx_byte_pool_available += HOST_BLOCK_HDR_SIZE;
+            }
+
+            avail = (uint32_t)(next_p - block_p) - HOST_BLOCK_HDR_SIZE;
+            if (avail >= memSize)
+            {
+                /* Split off the remainder if it is large enough to be useful. */
+                if ((avail - memSize) >= (HOST_BLOCK_HDR_SIZE + HOST_BLOCK_MIN))
+                {
+                    split_p = block_p + HOST_BLOCK_HDR_SIZE + memSize;
+                    HOST_BLOCK_NEXT (split_p) = next_p;
+                    HOST_BLOCK_MARK (split_p) = HOST_BLOCK_FREE;
+                    HOST_BLOCK_NEXT (block_p) = split_p;
+                    next_p = split_p;
+                    pool_p->tx_byte_pool_fragments++;
+                    pool_p->tx_byte_pool_available -= HOST_BLOCK_HDR_SIZE;
+                    avail = memSize;
+                }
+
+                HOST_BLOCK_MARK (block_p) = (uintptr_t)pool_p;
+                pool_p->tx_byte_pool_available -= avail;
+                pool_p->tx_byte_pool_search     = next_p;
+
+                *mem_p = block_p + HOST_BLOCK_HDR_SIZE;
+                return CY_U3P_SUCCESS;
+            }
+        }
+
+        block_p = next_p;
+    }
+
+    return CY_U3P_ERROR_NO_MEMORY;
+}
+
+uint32_t
+CyU3PByteFree (
+        void *mem_p)
+{
+    uint8_t       *block_p;
+    CyU3PBytePool *pool_p;
+
+    if (mem_p == 0)
+        return CY_U3P_ERROR_BAD_ARGUMENT;
+
+    block_p = (uint8_t *)mem_p - HOST_BLOCK_HDR_SIZE;
+    if (HOST_BLOCK_MARK (block_p) == HOST_BLOCK_FREE)
+        return CY_U3P_ERROR_BAD_ARGUMENT;
+
+    pool_p = (CyU3PBytePool *)HOST_BLOCK_MARK (block_p);
+    HOST_BLOCK_MARK (block_p) = HOST_BLOCK_FREE;
+    pool_p->tx_byte_pool_available += (uint32_t)(HOST_BLOCK_NEXT (block_p) - block_p) - HOST_BLOCK_HDR_SIZE;
+    pool_p->tx_byte_pool_search     = block_p;
+
+    return CY_U3P_SUCCESS;
+}
+
+/*[]*/
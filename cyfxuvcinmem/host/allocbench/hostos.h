@@ -0,0 +1,46 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (hostos.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_HOSTOS_H_
+#define _INCLUDED_HOSTOS_H_
+
+#include <cyu3types.h>
+
+/* FX3 system RAM window that is reproduced at its device address on the host. cyfxtx.c
+ * uses fixed heap addresses and stores addresses in 32-bit variables, so the window has
+ * to be mapped below 4 GB. */
+#define HOST_SYS_MEM_BASE       (0x40000000)
+#define HOST_SYS_MEM_SIZE       (0x80000)
+
+/* Map the system RAM window. Returns CyFalse if the address range is not available. */
+extern CyBool_t
+HostMapSysMem (
+        void);
+
+/* Select whether the allocator calls are made from thread (CyTrue) or interrupt context. */
+extern void
+HostSetThreadContext (
+        CyBool_t isThread);
+
+#endif /* _INCLUDED_HOSTOS_H_ */
+
+/*[]*/
@@ -0,0 +1,36 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyfxversion.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYFXVERSION_H_
+#define _INCLUDED_CYFXVERSION_H_
+
+/* SDK version that the host build of cyfxtx.c mimics. Memory error detection
+ * is supported from version 1.3.3 onwards. */
+
+#define CYFX_VERSION_MAJOR      (1)
+#define CYFX_VERSION_MINOR      (3)
+#define CYFX_VERSION_PATCH      (4)
+#define CYFX_VERSION_BUILD      (0)
+
+#endif /* _INCLUDED_CYFXVERSION_H_ */
+
+/*[]*/
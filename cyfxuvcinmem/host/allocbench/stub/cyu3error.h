@@ -0,0 +1,40 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3error.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3ERROR_H_
+#define _INCLUDED_CYU3ERROR_H_
+
+/* Subset of the FX3 SDK error codes needed to build cyfxtx.c on a host PC. */
+
+typedef uint32_t CyU3PReturnStatus_t;
+
+#define CY_U3P_SUCCESS                  (0x00)
+#define CY_U3P_ERROR_NO_MEMORY          (0x10)
+#define CY_U3P_ERROR_BAD_ARGUMENT       (0x40)
+#define CY_U3P_ERROR_MEMORY_ERROR       (0x43)
+#define CY_U3P_ERROR_ALREADY_STARTED    (0x44)
+#define CY_U3P_ERROR_TIMEOUT            (0x45)
+#define CY_U3P_ERROR_FAILURE            (0x46)
+
+#endif /* _INCLUDED_CYU3ERROR_H_ */
+
+/*[]*/
@@ -0,0 +1,159 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3os.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3OS_H_
+#define _INCLUDED_CYU3OS_H_
+
+#include <cyu3externcstart.h>
+#include <cyu3types.h>
+#include <cyu3error.h>
+
+/* Host replacement for the FX3 SDK OS abstraction layer. Only the services used by
+ * cyfxtx.c are provided; they are implemented in hostos.c on top of a single threaded
+ * process. The byte pool keeps the ThreadX block layout so that the heap walk done by
+ * CyU3PMemGetStats works unchanged. */
+
+#define CYU3P_NO_WAIT           (0)
+#define CYU3P_WAIT_FOREVER      (0xFFFFFFFF)
+#define CYU3P_NO_INHERIT        (0)
+#define CYU3P_INHERIT           (1)
+
+#define TX_INT_DISABLE          (0xC0)
+#define TX_INT_ENABLE           (0x00)
+
+typedef unsigned int UINT;
+
+/* Thread handle. Only used to tell thread context from interrupt context. */
+typedef struct CyU3PThread
+{
+    uint32_t id;
+} CyU3PThread;
+
+/* Mutex. There is only one thread on the host, so the mutex only tracks ownership
+ * to catch unbalanced get/put calls. */
+typedef struct CyU3PMutex
+{
+    uint32_t ownerCount;
+    CyBool_t created;
+} CyU3PMutex;
+
+/* Byte pool, using the ThreadX field names. */
+typedef struct CyU3PBytePool
+{
+    uint8_t  *tx_byte_pool_start;       /* Start of the pool memory. */
+    uint32_t  tx_byte_pool_size;        /* Size of the pool memory. */
+    uint32_t  tx_byte_pool_available;   /* Bytes available for allocation. */
+    uint32_t  tx_byte_pool_fragments;   /* Number of blocks in the pool. */
+    uint8_t  *tx_byte_pool_search;      /* Block from which the next search starts. */
+} CyU3PBytePool;
+
+/* Header added to each block when memory leak and corruption checks are enabled. */
+typedef struct MemBlockInfo
+{
+    uint32_t             alloc_id;
+    uint32_t             alloc_size;
+    struct MemBlockInfo *prev_blk;
+    struct MemBlockInfo *next_blk;
+    uint32_t             start_sig;
+} MemBlockInfo;
+
+typedef void (*CyU3PMemCorruptCallback) (
+        void *mem_p);
+
+extern UINT
+tx_interrupt_control (
+        UINT new_posture);
+
+extern CyU3PThread *
+CyU3PThreadIdentify (
+        void);
+
+extern uint32_t
+CyU3PMutexCreate (
+        CyU3PMutex *mutex_p,
+        uint32_t    priorityInherit);
+
+extern uint32_t
+CyU3PMutexDestroy (
+        CyU3PMutex *mutex_p);
+
+extern uint32_t
+CyU3PMutexGet (
+        CyU3PMutex *mutex_p,
+        uint32_t    waitOption);
+
+extern uint32_t
+CyU3PMutexPut (
+        CyU3PMutex *mutex_p);
+
+extern uint32_t
+CyU3PBytePoolCreate (
+        CyU3PBytePool *pool_p,
+        void          *poolStart,
+        uint32_t       poolSize);
+
+extern uint32_t
+CyU3PBytePoolDestroy (
+        CyU3PBytePool *pool_p);
+
+extern uint32_t
+CyU3PByteAlloc (
+        CyU3PBytePool *pool_p,
+        void         **mem_p,
+        uint32_t       memSize,
+        uint32_t       waitOption);
+
+extern uint32_t
+CyU3PByteFree (
+        void *mem_p);
+
+extern void
+CyU3PApplicationDefine (
+        void);
+
+/* Allocator interface implemented by cyfxtx.c. */
+extern void  CyU3PMemInit (void);
+extern void *CyU3PMemAlloc (uint32_t size);
+extern void  CyU3PMemFree (void *mem_p);
+extern void  CyU3PMemSet (uint8_t *ptr, uint8_t data, uint32_t count);
+extern void  CyU3PMemCopy (uint8_t *dest, uint8_t *src, uint32_t count);
+extern int32_t CyU3PMemCmp (const void *s1, const void *s2, uint32_t n);
+extern void  CyU3PDmaBufferInit (void);
+extern void  CyU3PDmaBufferDeInit (void);
+extern void *CyU3PDmaBufferAlloc (uint16_t size);
+extern int   CyU3PDmaBufferFree (void *buffer);
+extern void  CyU3PFreeHeaps (void);
+
+extern CyU3PReturnStatus_t CyU3PMemEnableChecks (CyBool_t enable, CyU3PMemCorruptCallback cb);
+extern CyU3PReturnStatus_t CyU3PBufEnableChecks (CyBool_t enable, CyU3PMemCorruptCallback cb);
+extern uint32_t CyU3PMemCorruptionCheck (void);
+extern uint32_t CyU3PBufCorruptionCheck (void);
+extern void CyU3PMemGetCounts (uint32_t *allocCnt_p, uint32_t *freeCnt_p);
+extern void CyU3PBufGetCounts (uint32_t *allocCnt_p, uint32_t *freeCnt_p);
+extern MemBlockInfo *CyU3PMemGetActiveList (void);
+extern MemBlockInfo *CyU3PBufGetActiveList (void);
+
+#include <cyu3externcend.h>
+
+#endif /* _INCLUDED_CYU3OS_H_ */
+
+/*[]*/
@@ -0,0 +1,35 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3system.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3SYSTEM_H_
+#define _INCLUDED_CYU3SYSTEM_H_
+
+/* Subset of the FX3 SDK system functions needed to build cyfxtx.c on a host PC. The host has no
+   cache that needs to be maintained for DMA, so the cache maintenance calls do nothing. */
+
+#define CyU3PSysCleanDRegion(addr, len)         ((void)(addr), (void)(len))
+#define CyU3PSysFlushDRegion(addr, len)         ((void)(addr), (void)(len))
+#define CyU3PSysClearDRegion(addr, len)         ((void)(addr), (void)(len))
+
+#endif /* _INCLUDED_CYU3SYSTEM_H_ */
+
+/*[]*/
@@ -0,0 +1,42 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3types.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3TYPES_H_
+#define _INCLUDED_CYU3TYPES_H_
+
+/* Subset of the FX3 SDK basic types needed to build cyfxtx.c on a host PC. */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int CyBool_t;                   /* Boolean type. */
+
+#define CyTrue                  (1)
+#define CyFalse                 (0)
+
+typedef volatile uint32_t uvint32_t;
+typedef volatile uint16_t uvint16_t;
+typedef volatile uint8_t  uvint8_t;
+
+#endif /* _INCLUDED_CYU3TYPES_H_ */
+
+/*[]*/
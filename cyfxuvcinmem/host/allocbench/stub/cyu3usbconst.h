@@ -0,0 +1,31 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3usbconst.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3USBCONST_H_
+#define _INCLUDED_CYU3USBCONST_H_
+
+/* Placeholder so that the application header can be included in the host build to
+ * share the stream buffer sizing constants. No USB definitions are needed. */
+
+#endif /* _INCLUDED_CYU3USBCONST_H_ */
+
+/*[]*/
@@ -0,0 +1,33 @@
+/*
+ ## Cypress FX3 Host Benchmark Header File (cyu3utils.h)
+ ## ===========================
+ ##
+ ##  Copyright Cypress Semiconductor Corporation, 2010-2018,
+ ##  All Rights Reserved
+ ##  UNPUBLISHED, LICENSED SOFTWARE.
+ ##
+ ##  CONFIDENTIAL AND PROPRIETARY INFORMATION
+ ##  WHICH IS THE PROPERTY OF CYPRESS.
+ ##
+ ##  Use of this file is governed
+ ##  by the license agreement included in the file
+ ##
+ ##     <install>/license/license.txt
+ ##
+ ##  where <install> is the Cypress software
+ ##  installation root directory path.
+ ##
+ ## ===========================
+*/
+
+#ifndef _INCLUDED_CYU3UTILS_H_
+#define _INCLUDED_CYU3UTILS_H_
+
+/* Subset of the FX3 SDK utility macros needed to build cyfxtx.c on a host PC. */
+
+#define CY_U3P_MIN(a,b)         (((a) > (b)) ? (b) : (a))
+#define CY_U3P_MAX(a,b)         (((a) > (b)) ? (a) : (b))
+
+#endif /* _INCLUDED_CYU3UTILS_H_ */
+
+/*[]*/
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+#
+# Copyright Cypress Semiconductor Corporation, 2010-2018,
+# All Rights Reserved
+# UNPUBLISHED, LICENSED SOFTWARE.
+#
+# CONFIDENTIAL AND PROPRIETARY INFORMATION
+# WHICH IS THE PROPERTY OF CYPRESS.
+#
+# Use of this file is governed
+# by the license agreement included in the file
+#
+#      <install>/license/license.txt
+#
+# where <install> is the Cypress software
+# installation root directory path.
+#
+
+"""Summarize the section sizes in a GNU ld map file of the firmware.
+
+Prints the size of each allocated output section, the totals per FX3 memory (I-TCM, D-TCM and
+system RAM) and the code and data contributed by each application object and SDK library. When
+a baseline report written by an earlier run is given, the change against it is printed as well.
+
+Usage:
+  mapsize.py cyfxuvcinmem.map [-b baseline.size] [-o report.size]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# FX3 memory map.
+MEMORIES = (
+    ("I-TCM", 0x00000000, 0x00004000),
+    ("D-TCM", 0x10000000, 0x10002000),
+    ("SYSMEM", 0x40000000, 0x40080000),
+)
+
+# Output sections that do not take up space on the device.
+IGNORED = re.compile(r"^\.(debug|comment|ARM\.attributes|stab)")
+
+OUTPUT_RE = re.compile(r"^(\.?[\w.$-]+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+INPUT_RE = re.compile(r"^ (\*?\.?[\w.$*-]+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+NAME_ONLY_RE = re.compile(r"^ ?(\.?[\w.$-]+)\s*$")
+
+
+def memory_of(addr):
+    for name, start, end in MEMORIES:
+        if start <= addr < end:
+            return name
+    return "other"
+
+
+def owner_of(path):
+    """Group input files by archive (SDK library) or by object file (application)."""
+    m = re.match(r"(.*\.a)\((.*)\)$", path)
+    if m:
+        return os.path.basename(m.group(1))
+    return os.path.basename(path)
+
+
+def parse_map(path):
+    sections = []       # (name, addr, size)
+    owners = {}         # owner -> [code, data]
+    in_map = False
+    current = None
+    pending = None
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+
+            # Long section names are printed on a line of their own.
+            if pending is not None:
+                line = pending + line
+                pending = None
+            m = NAME_ONLY_RE.match(line)
+            if m and not line.startswith("LOAD") and not line.startswith("OUTPUT"):
+                pending = line
+                continue
+
+            m = OUTPUT_RE.match(line)
+            if m and not line.startswith(" "):
+                name, addr, size = m.group(1), int(m.group(2), 16), int(m.group(3), 16)
+                current = None
+                if size and not IGNORED.match(name):
+                    current = (name, addr, size)
+                    sections.append(current)
+                continue
+
+            m = INPUT_RE.match(line)
+            if m and current is not None:
+                size = int(m.group(3), 16)
+                if size == 0 or m.group(4).startswith("*fill*"):
+                    continue
+                code = current[0].startswith(".text") or memory_of(current[1]) == "I-TCM"
+                entry = owners.setdefault(owner_of(m.group(4).strip()), [0, 0])
+                entry[0 if code else 1] += size
+
+    return sections, owners
+
+
+def make_report(sections, owners):
+    lines = []
+    for name, addr, size in sections:
+        lines.append("section %-24s 0x%08x %8d %s" % (name, addr, size, memory_of(addr)))
+
+    totals = {}
+    for name, addr, size in sections:
+        mem = memory_of(addr)
+        totals[mem] = totals.get(mem, 0) + size
+    for name, start, end in MEMORIES:
+        lines.append("memory  %-24s %8d of %d" % (name, totals.get(name, 0), end - start))
+
+    for owner in sorted(owners, key=lambda o: -(owners[o][0] + owners[o][1])):
+        code, data = owners[owner]
+        lines.append("object  %-32s code %8d data %8d" % (owner, code, data))
+    return lines
+
+
+def report_values(lines):
+    """Key the numbers of a report so that two reports can be compared."""
+    values = {}
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        if fields[0] == "section":
+            values[("section", fields[1])] = int(fields[3])
+        elif fields[0] == "memory":
+            values[("memory", fields[1])] = int(fields[2])
+        elif fields[0] == "object":
+            values[("code", fields[1])] = int(fields[3])
+            values[("data", fields[1])] = int(fields[5])
+    return values
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mapfile")
+    parser.add_argument("-b", "--baseline", help="earlier report to compare against")
+    parser.add_argument("-o", "--output", help="file to save this report in")
+    args = parser.parse_args()
+
+    sections, owners = parse_map(args.mapfile)
+    if not sections:
+        sys.exit("%s: no memory map found" % args.mapfile)
+    report = make_report(sections, owners)
+
+    base = {}
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            base = report_values(f.read().splitlines())
+
+    cur = report_values(report)
+    for line in report:
+        print(line)
+
+    if base:
+        print("Change against %s:" % args.baseline)
+        changed = False
+        for key in sorted(set(cur) | set(base)):
+            delta = cur.get(key, 0) - base.get(key, 0)
+            if delta:
+                print("  %-7s %-32s %+8d" % (key[0], key[1], delta))
+                changed = True
+        if not changed:
+            print("  none")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write("\n".join(report) + "\n")
+
+
+if __name__ == "__main__":
+    main()
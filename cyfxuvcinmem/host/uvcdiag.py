@@ -0,0 +1,413 @@
+#!/usr/bin/env python3
+#
+# Copyright Cypress Semiconductor Corporation, 2010-2018,
+# All Rights Reserved
+# UNPUBLISHED, LICENSED SOFTWARE.
+#
+# CONFIDENTIAL AND PROPRIETARY INFORMATION
+# WHICH IS THE PROPERTY OF CYPRESS.
+#
+# Use of this file is governed
+# by the license agreement included in the file
+#
+#      <install>/license/license.txt
+#
+# where <install> is the Cypress software
+# installation root directory path.
+#
+
+"""Read diagnostic information from the UVC in-memory example over its vendor requests.
+
+Commands:
+  heap             Print the driver and buffer heap statistics (0xB0).
+  memcheck         Print the background memory check results (0xB1).
+  boot             Print the start-up stage times (0xB3).
+  header FORMAT    Select the payload header format (0xB4): min, pts or pts-scr. Takes effect
+                   when the host next commits the stream settings.
+  stats [--reset]  Print the streaming statistics (0xB5). With --reset, clear them afterwards (0xB6).
+  hist [--reset]   Print the per-stage latency histograms (0xB9). With --reset, clear them and the
+                   streaming statistics afterwards (0xB6).
+  cpu [-n N]       Print the CPU load over the sliding window (0xBA), N times (CYFX_CPU_LOAD=1).
+  stacks [-m PCT]  Print the size and peak usage of every thread stack (0xBD), with a suggested size
+                   of the peak plus PCT percent, rounded up to 256 bytes.
+  trace -o FILE    Save the event trace area (0xB7) as a TraceX file. The trace is paused while it
+                   is read (0xB8). --print also lists the events, --clear empties the ring afterwards.
+  profile -o FILE  Clear and run the PC sampling profiler (0xBC) for --time seconds at --rate Hz, then
+                   save the histogram area (0xBB) for host/uvcprof.py (CYFX_PC_PROFILE=1).
+  blocks -o FILE   Capture snapshots of the in-use block lists of both heaps (0xB2) in the
+                   format read by the allocbench trace workload.
+  watch            Start the telemetry records (0xBE, every --period MS, default 1000) and print
+                   them from the endpoint of the vendor telemetry interface (0x84). The records
+                   are stopped again on exit. --all watches every device with the VID/PID at once.
+                   The interface is not used by the video driver, so the device can stream
+                   to a video application meanwhile.
+
+Requires pyusb.
+"""
+
+import argparse
+import struct
+import sys
+import threading
+import time
+
+import usb.core
+
+VID = 0x04B4
+PID = 0x4722
+
+VENDOR_GET_REQ_TYPE = 0xC0
+VENDOR_SET_REQ_TYPE = 0x40
+RQT_GET_HEAP_STATS = 0xB0
+RQT_GET_MEM_CHECK = 0xB1
+RQT_GET_HEAP_BLOCKS = 0xB2
+RQT_GET_BOOT_PROFILE = 0xB3
+RQT_SET_HEADER_FORMAT = 0xB4
+RQT_GET_STREAM_STATS = 0xB5
+RQT_RESET_STREAM_STATS = 0xB6
+RQT_GET_TRACE = 0xB7
+RQT_TRACE_CONTROL = 0xB8
+RQT_GET_STAGE_HIST = 0xB9
+RQT_GET_CPU_LOAD = 0xBA
+RQT_GET_PROFILE = 0xBB
+RQT_PROFILE_CONTROL = 0xBC
+RQT_GET_STACK_USAGE = 0xBD
+RQT_TELEMETRY_CONTROL = 0xBE
+
+TRACE_PAUSE, TRACE_RESUME, TRACE_CLEAR = 0, 1, 2
+PROFILE_STOP, PROFILE_START, PROFILE_CLEAR = 0, 1, 2
+
+HEADER_FORMATS = ("min", "pts", "pts-scr")
+
+EP0_BUFFER_SIZE = 512
+
+HEAP_STATS_FIELDS = ("totalSize", "usedSize", "peakUsedSize", "largestFree", "freeFragments", "allocFailCount")
+MEM_CHECK_FIELDS = ("runCount", "memBlocksChecked", "bufBlocksChecked", "checkFailCount", "badBlockCount",
+                    "lastBadBlock", "bufCheckSkipCount")
+BOOT_STAGES = ("main", "kernel entry", "app define", "thread", "debug init", "usb start", "connect",
+               "set config")
+STREAM_STATS_FIELDS = ("byteCount", "bufCount", "frameCount", "multChangeCount", "bufWaitCount",
+                       "commitFailCount", "consEventCount", "startCount", "stopCount", "underrunCount",
+                       "underrunFrames", "underrunFrameMax", "errPayloadCount", "underrunUnmarked")
+STREAM_STATS = struct.Struct("<Q13I")
+BLOCK_RECORD = struct.Struct("<III")
+HIST_STAGES = ("buffer wait", "fill", "commit", "event interval", "control request")
+HIST_BUCKETS = 16
+HISTOGRAM = struct.Struct("<QII%dI" % HIST_BUCKETS)
+CPU_LOAD = struct.Struct("<IIII")
+CPU_THREAD = struct.Struct("<20sI")
+CPU_MAX_THREADS = 16
+STACK_USAGE = struct.Struct("<20sIII")
+STACK_MAX_THREADS = 16
+STACK_ROUND = 256
+
+# Telemetry interface endpoint packets (cyfxuvcstatus.h).
+EP_TELEMETRY = 0x84
+STATUS_PACKET_SIZE = 64
+STATUS_TYPE_TELEMETRY = 0xFF
+TELEMETRY_PERIOD = 1000
+STREAM_MODES = ("idle", "ready", "active")
+TELEMETRY = struct.Struct("<BBBBIIIIIIIIIIII")
+TELEMETRY_VERSION = 1
+TELEMETRY_NO_CPU = 0xFFFFFFFF
+
+# ThreadX trace buffer layout (cyfxuvctrace.h).
+TRACE_VALID = 0x54585442
+TRACE_HEADER = struct.Struct("<IIIIHHIIIIIII")
+TRACE_OBJECT = struct.Struct("<BBBBIII32s")
+TRACE_ENTRY = struct.Struct("<IIII4I")
+TRACE_EVENTS = {4096: "get_buffer", 4097: "fill", 4098: "commit", 4099: "dma_cb", 4100: "usb_event",
+                4101: "setup", 4102: "msg", 4103: "bench",
+                4104: "underrun"}
+
+
+def vendor_get(dev, request, length, value=0, index=0):
+    return bytes(dev.ctrl_transfer(VENDOR_GET_REQ_TYPE, request, value, index, length))
+
+
+def unpack_words(data, fields):
+    return dict(zip(fields, struct.unpack("<%dI" % len(fields), data[:4 * len(fields)])))
+
+
+def cmd_heap(dev, args):
+    size = 4 * len(HEAP_STATS_FIELDS)
+    data = vendor_get(dev, RQT_GET_HEAP_STATS, 2 * size)
+    for name, chunk in (("driver heap", data[:size]), ("buffer heap", data[size:])):
+        stats = unpack_words(chunk, HEAP_STATS_FIELDS)
+        print("%s:" % name)
+        for field in HEAP_STATS_FIELDS:
+            print("  %-16s %u" % (field, stats[field]))
+
+
+def cmd_memcheck(dev, args):
+    stats = unpack_words(vendor_get(dev, RQT_GET_MEM_CHECK, 4 * len(MEM_CHECK_FIELDS)), MEM_CHECK_FIELDS)
+    for field in MEM_CHECK_FIELDS:
+        fmt = "  %-18s 0x%08x" if field == "lastBadBlock" else "  %-18s %u"
+        print(fmt % (field, stats[field]))
+
+
+def cmd_boot(dev, args):
+    data = vendor_get(dev, RQT_GET_BOOT_PROFILE, 4 * (1 + len(BOOT_STAGES)))
+    words = struct.unpack("<%dI" % (1 + len(BOOT_STAGES)), data[:4 * (1 + len(BOOT_STAGES))])
+    mask, ticks = words[0], words[1:]
+    # The system tick only runs once the kernel has started, so earlier stages show 0 ms.
+    for stage, name in enumerate(BOOT_STAGES):
+        if mask & (1 << stage):
+            print("  %-16s %6u ms" % (name, ticks[stage]))
+        else:
+            print("  %-16s %6s" % (name, "-"))
+
+
+def cmd_header(dev, args):
+    dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_SET_HEADER_FORMAT, HEADER_FORMATS.index(args.format), 0, None)
+
+
+def cmd_stats(dev, args):
+    data = vendor_get(dev, RQT_GET_STREAM_STATS, STREAM_STATS.size)
+    stats = dict(zip(STREAM_STATS_FIELDS, STREAM_STATS.unpack(data[:STREAM_STATS.size])))
+    for field in STREAM_STATS_FIELDS:
+        print("  %-16s %u" % (field, stats[field]))
+    if args.reset:
+        dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_RESET_STREAM_STATS, 0, 0, None)
+
+
+def bucket_label(bucket):
+    if bucket == 0:
+        return "0"
+    if bucket == HIST_BUCKETS - 1:
+        return ">=%u" % (1 << (bucket - 1))
+    return "%u-%u" % (1 << (bucket - 1), (1 << bucket) - 1)
+
+
+def cmd_hist(dev, args):
+    data = vendor_get(dev, RQT_GET_STAGE_HIST, HISTOGRAM.size * len(HIST_STAGES))
+    hists = [HISTOGRAM.unpack_from(data, i * HISTOGRAM.size) for i in range(len(HIST_STAGES))]
+    print("%-12s" % "us" + "".join("%16s" % name for name in HIST_STAGES))
+    for bucket in range(HIST_BUCKETS):
+        print("%-12s" % bucket_label(bucket) + "".join("%16u" % hist[3 + bucket] for hist in hists))
+    print("%-12s" % "samples" + "".join("%16u" % hist[2] for hist in hists))
+    print("%-12s" % "avg" + "".join("%16u" % (hist[0] // hist[2] if hist[2] else 0) for hist in hists))
+    print("%-12s" % "max" + "".join("%16u" % hist[1] for hist in hists))
+    if args.reset:
+        dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_RESET_STREAM_STATS, 0, 0, None)
+
+
+def permille(value):
+    return "%3u.%u %%" % (value // 10, value % 10)
+
+
+def cmd_cpu(dev, args):
+    for snap in range(args.count):
+        if snap != 0:
+            time.sleep(args.interval / 1000.0)
+        data = vendor_get(dev, RQT_GET_CPU_LOAD, CPU_LOAD.size + CPU_MAX_THREADS * CPU_THREAD.size)
+        window_us, idle, isr, count = CPU_LOAD.unpack_from(data)
+        threads = [CPU_THREAD.unpack_from(data, CPU_LOAD.size + i * CPU_THREAD.size) for i in range(count)]
+        print("window %u ms" % (window_us // 1000))
+        print("  %-20s %s" % ("idle", permille(idle)))
+        print("  %-20s %s" % ("interrupts", permille(isr)))
+        for name, share in sorted(threads, key=lambda t: -t[1]):
+            print("  %-20s %s" % (name.split(b"\0")[0].decode("ascii", "replace"), permille(share)))
+
+
+def cmd_stacks(dev, args):
+    data = vendor_get(dev, RQT_GET_STACK_USAGE, STACK_MAX_THREADS * STACK_USAGE.size)
+    print("%-20s %8s %8s %6s %8s %9s" % ("thread", "size", "peak", "peak%", "current", "suggested"))
+    total = suggested_total = 0
+    for offset in range(0, len(data) - STACK_USAGE.size + 1, STACK_USAGE.size):
+        name, size, peak, current = STACK_USAGE.unpack_from(data, offset)
+        suggested = peak + peak * args.margin // 100
+        suggested = (suggested + STACK_ROUND - 1) // STACK_ROUND * STACK_ROUND
+        total += size
+        suggested_total += suggested
+        print("%-20s %8u %8u %5.1f%% %8u %9u" % (name.split(b"\0")[0].decode("ascii", "replace"), size, peak,
+                                                100.0 * peak / (size or 1), current, suggested))
+    print("%-20s %8u %8s %6s %8s %9u" % ("total", total, "", "", "", suggested_total))
+
+
+def print_trace(data):
+    (trace_id, _, base, reg_start, _, name_size, reg_end, buf_start, buf_end, buf_current,
+     _, _, _) = TRACE_HEADER.unpack_from(data)
+    if trace_id != TRACE_VALID:
+        sys.exit("trace area not initialized")
+    threads = {}
+    for offset in range(reg_start - base, reg_end - base, TRACE_OBJECT.size):
+        available, _, _, _, obj, _, _, name = TRACE_OBJECT.unpack_from(data, offset)
+        if not available:
+            threads[obj] = name.split(b"\0")[0].decode("ascii", "replace")
+    # The entry at buf_current is the oldest one once the ring has wrapped.
+    offsets = list(range(buf_start - base, buf_end - base, TRACE_ENTRY.size))
+    split = (buf_current - buf_start) // TRACE_ENTRY.size
+    for offset in offsets[split:] + offsets[:split]:
+        thread, _, event, stamp, i1, i2, i3, _ = TRACE_ENTRY.unpack_from(data, offset)
+        if event == 0:
+            continue
+        print("%10u  %-20s %-10s 0x%08x 0x%08x 0x%08x" % (stamp, threads.get(thread, "0x%08x" % thread),
+                                                       TRACE_EVENTS.get(event, str(event)), i1, i2, i3))
+
+
+def read_area(dev, request):
+    """Read a diagnostic area that is returned in parts, addressed by the byte offset in wIndex."""
+    data = b""
+    while True:
+        chunk = vendor_get(dev, request, EP0_BUFFER_SIZE, 0, len(data))
+        data += chunk
+        if len(chunk) < EP0_BUFFER_SIZE:
+            return data
+
+
+def cmd_trace(dev, args):
+    dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_TRACE_CONTROL, TRACE_PAUSE, 0, None)
+    try:
+        data = read_area(dev, RQT_GET_TRACE)
+    finally:
+        dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_TRACE_CONTROL, TRACE_CLEAR if args.clear else TRACE_RESUME,
+                          0, None)
+    with open(args.output, "wb") as out:
+        out.write(data)
+    print("wrote %d bytes to %s" % (len(data), args.output))
+    if args.print:
+        print_trace(data)
+
+
+def cmd_profile(dev, args):
+    dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_PROFILE_CONTROL, PROFILE_CLEAR, args.rate, None)
+    try:
+        time.sleep(args.time)
+    finally:
+        dev.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_PROFILE_CONTROL, PROFILE_STOP, 0, None)
+    data = read_area(dev, RQT_GET_PROFILE)
+    with open(args.output, "wb") as out:
+        out.write(data)
+    print("wrote %d bytes to %s" % (len(data), args.output))
+
+
+def read_blocks(dev, heap):
+    """Read the in-use list of one heap (0 = driver heap, 1 = buffer heap), newest block first."""
+    blocks = []
+    per_request = EP0_BUFFER_SIZE // BLOCK_RECORD.size
+    while True:
+        data = vendor_get(dev, RQT_GET_HEAP_BLOCKS, per_request * BLOCK_RECORD.size, heap, len(blocks))
+        blocks.extend(BLOCK_RECORD.iter_unpack(data[:len(data) - len(data) % BLOCK_RECORD.size]))
+        if len(data) < per_request * BLOCK_RECORD.size:
+            return blocks
+
+
+def cmd_blocks(dev, args):
+    with open(args.output, "w") as out:
+        out.write("# In-use heap blocks: M|B <alloc id> <alloc size incl. check overhead (M: 24, B: 36 bytes)> <address>\n")
+        for snap in range(args.count):
+            if snap != 0:
+                time.sleep(args.interval / 1000.0)
+            out.write("S\n")
+            for heap, tag in ((0, "M"), (1, "B")):
+                # The list may change while it is being read out in parts; drop duplicates.
+                seen = set()
+                for alloc_id, size, addr in read_blocks(dev, heap):
+                    if alloc_id not in seen:
+                        seen.add(alloc_id)
+                        out.write("%s %u %u 0x%08x\n" % (tag, alloc_id, size, addr))
+    print("wrote %d snapshots to %s" % (args.count, args.output))
+
+
+def format_status(data):
+    if len(data) >= TELEMETRY.size and data[0] == STATUS_TYPE_TELEMETRY and data[1] == TELEMETRY_VERSION:
+        (_, _, mode, _, sequence, _, period_us, byte_count, frame_count, underruns, cpu_idle, mem_used,
+         mem_free, buf_used, buf_free, drops) = TELEMETRY.unpack_from(data)
+        period_us = period_us or 1
+        return ("#%u %-6s %7.2f Mbit/s %5.1f fps  underruns %u  cpu idle %s  mem %u used %u free  "
+                "buf %u used %u free  drops %u" %
+                (sequence, STREAM_MODES[mode] if mode < len(STREAM_MODES) else mode,
+                 byte_count * 8.0 / period_us, frame_count * 1e6 / period_us, underruns,
+                 "n/a" if cpu_idle == TELEMETRY_NO_CPU else permille(cpu_idle).strip(),
+                 mem_used, mem_free, buf_used, buf_free, drops))
+    return "packet: " + " ".join("%02x" % b for b in data)
+
+
+def watch_device(dev, args, lock):
+    name = "%03u:%03u" % (dev.bus or 0, dev.address or 0)
+    count = 0
+    while args.count == 0 or count < args.count:
+        try:
+            data = bytes(dev.read(EP_TELEMETRY, STATUS_PACKET_SIZE, timeout=1000))
+        except usb.core.USBTimeoutError:
+            continue
+        count += 1
+        with lock:
+            print("%s %s" % (name, format_status(data)))
+            sys.stdout.flush()
+
+
+def cmd_watch(dev, args):
+    devices = list(usb.core.find(find_all=True, idVendor=args.vid, idProduct=args.pid)) if args.all else [dev]
+    for d in devices:
+        d.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_TELEMETRY_CONTROL, args.period, 0, None)
+    lock = threading.Lock()
+    threads = [threading.Thread(target=watch_device, args=(d, args, lock), daemon=True) for d in devices]
+    for thread in threads:
+        thread.start()
+    try:
+        for thread in threads:
+            while thread.is_alive():
+                thread.join(0.5)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for d in devices:
+            d.ctrl_transfer(VENDOR_SET_REQ_TYPE, RQT_TELEMETRY_CONTROL, 0, 0, None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--vid", type=lambda s: int(s, 0), default=VID)
+    parser.add_argument("--pid", type=lambda s: int(s, 0), default=PID)
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("heap").set_defaults(func=cmd_heap)
+    sub.add_parser("memcheck").set_defaults(func=cmd_memcheck)
+    sub.add_parser("boot").set_defaults(func=cmd_boot)
+    header = sub.add_parser("header")
+    header.add_argument("format", choices=HEADER_FORMATS)
+    header.set_defaults(func=cmd_header)
+    stats = sub.add_parser("stats")
+    stats.add_argument("--reset", action="store_true")
+    stats.set_defaults(func=cmd_stats)
+    hist = sub.add_parser("hist")
+    hist.add_argument("--reset", action="store_true")
+    hist.set_defaults(func=cmd_hist)
+    cpu = sub.add_parser("cpu")
+    cpu.add_argument("-n", "--count", type=int, default=1, help="number of readings")
+    cpu.add_argument("-i", "--interval", type=int, default=1000, help="ms between readings")
+    cpu.set_defaults(func=cmd_cpu)
+    stacks = sub.add_parser("stacks")
+    stacks.add_argument("-m", "--margin", type=int, default=25, help="percent added to the peak")
+    stacks.set_defaults(func=cmd_stacks)
+    trace = sub.add_parser("trace")
+    trace.add_argument("-o", "--output", required=True)
+    trace.add_argument("--print", action="store_true")
+    trace.add_argument("--clear", action="store_true")
+    trace.set_defaults(func=cmd_trace)
+    profile = sub.add_parser("profile")
+    profile.add_argument("-o", "--output", required=True)
+    profile.add_argument("-r", "--rate", type=int, default=1000, help="samples per second (up to 20000)")
+    profile.add_argument("-t", "--time", type=float, default=10.0, help="seconds to sample")
+    profile.set_defaults(func=cmd_profile)
+    blocks = sub.add_parser("blocks")
+    blocks.add_argument("-o", "--output", required=True, help="snapshot file to write")
+    blocks.add_argument("-n", "--count", type=int, default=100, help="number of snapshots")
+    blocks.add_argument("-i", "--interval", type=int, default=50, help="ms between snapshots")
+    blocks.set_defaults(func=cmd_blocks)
+    watch = sub.add_parser("watch")
+    watch.add_argument("-p", "--period", type=int, default=TELEMETRY_PERIOD, help="ms between telemetry records")
+    watch.add_argument("-n", "--count", type=int, default=0, help="packets to print per device, 0 for no limit")
+    watch.add_argument("--all", action="store_true", help="watch every device with the VID/PID")
+    watch.set_defaults(func=cmd_watch)
+    args = parser.parse_args()
+
+    dev = usb.core.find(idVendor=args.vid, idProduct=args.pid)
+    if dev is None:
+        sys.exit("device %04x:%04x not found" % (args.vid, args.pid))
+    args.func(dev, args)
+
+
+if __name__ == "__main__":
+    main()
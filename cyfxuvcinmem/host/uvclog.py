@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Copyright Cypress Semiconductor Corporation, 2010-2018,
+# All Rights Reserved
+# UNPUBLISHED, LICENSED SOFTWARE.
+#
+# CONFIDENTIAL AND PROPRIETARY INFORMATION
+# WHICH IS THE PROPERTY OF CYPRESS.
+#
+# Use of this file is governed
+# by the license agreement included in the file
+#
+#      <install>/license/license.txt
+#
+# where <install> is the Cypress software
+# installation root directory path.
+#
+
+"""Decode the deferred log records in a capture of the debug UART output.
+
+Firmware built with CYFX_DEFERRED_LOG=1 sends the messages of CY_FX_UVC_LOG as records of the form
+"@<time stamp> <format address> <argument> ..." (all hex). The format strings, and the strings
+passed for %s, are read from the firmware ELF file. All other lines are passed through unchanged.
+
+Usage:
+  uvclog.py cyfxuvcinmem.elf [capture.txt]      (reads the capture from stdin if not given)
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r"%(%|[-+ #0-9.]*[a-zA-Z])")
+
+
+class Elf32Image:
+    """Contents of the allocated sections of a little endian ELF32 file, by load address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            sys.exit("%s: not a little endian ELF32 file" % path)
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size != 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, contents in self.sections:
+            if base <= addr < base + len(contents):
+                end = contents.find(b"\0", addr - base)
+                return contents[addr - base:end if end >= 0 else len(contents)].decode("ascii", "replace")
+        return None
+
+
+def format_record(image, fmt_addr, args):
+    if fmt_addr == 0:
+        return "<%u log messages dropped>\n" % args[0]
+    fmt = image.string(fmt_addr)
+    if fmt is None:
+        return "<unknown format 0x%08x: %s>\n" % (fmt_addr, " ".join("0x%x" % a for a in args))
+    args = iter(args)
+
+    def convert(match):
+        spec = match.group(1)
+        if spec == "%":
+            return "%"
+        value = next(args, 0)
+        kind = spec[-1]
+        if kind == "s":
+            text = image.string(value)
+            return text if text is not None else "<0x%08x>" % value
+        if kind == "d" and value >= 0x80000000:
+            value -= 0x100000000
+        if kind not in "diouxXc":
+            spec = spec[:-1] + "x"
+        return ("%" + spec) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf")
+    parser.add_argument("capture", nargs="?")
+    args = parser.parse_args()
+
+    image = Elf32Image(args.elf)
+    source = open(args.capture, errors="replace") if args.capture else sys.stdin
+    for line in source:
+        fields = line.split()
+        if not line.startswith("@") or len(fields) < 2:
+            sys.stdout.write(line)
+            continue
+        try:
+            values = [int(field.lstrip("@"), 16) for field in fields]
+        except ValueError:
+            sys.stdout.write(line)
+            continue
+        sys.stdout.write("%10u  %s" % (values[0], format_record(image, values[1], values[2:]).replace("\r", "")))
+
+
+if __name__ == "__main__":
+    main()
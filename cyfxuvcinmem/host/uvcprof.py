@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# Copyright Cypress Semiconductor Corporation, 2010-2018,
+# All Rights Reserved
+# UNPUBLISHED, LICENSED SOFTWARE.
+#
+# CONFIDENTIAL AND PROPRIETARY INFORMATION
+# WHICH IS THE PROPERTY OF CYPRESS.
+#
+# Use of this file is governed
+# by the license agreement included in the file
+#
+#      <install>/license/license.txt
+#
+# where <install> is the Cypress software
+# installation root directory path.
+#
+
+"""Map a PC sampling histogram to the functions of the firmware.
+
+The histogram is captured from firmware built with CYFX_PC_PROFILE=1 with
+  uvcdiag.py profile -o profile.bin
+Each bin counts the samples taken in a fixed size block of code (see cyfxuvcprof.h). The count of a
+bin is shared between the functions it overlaps in proportion to the overlap, using the symbol
+table of the ELF file of the same build.
+
+Usage:
+  uvcprof.py cyfxuvcinmem.elf profile.bin [-n COUNT] [--bins]
+"""
+
+import argparse
+import bisect
+import struct
+import sys
+
+PROF_MAGIC = 0x46525043
+PROF_HEADER = struct.Struct("<8I")
+
+SHT_SYMTAB = 2
+STT_NOTYPE = 0
+STT_FUNC = 2
+SYMBOL = struct.Struct("<IIIBBH")
+
+
+def read_functions(path):
+    """Return the sorted (start, end, name) code ranges of the function symbols of an ELF32 file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        sys.exit("%s: not a little endian ELF32 file" % path)
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    sections = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+
+    symbols = {}
+    for (_, sh_type, _, _, offset, size, link, _, _, entsize) in sections:
+        if sh_type != SHT_SYMTAB:
+            continue
+        strtab = sections[link]
+        strings = data[strtab[4]:strtab[4] + strtab[5]]
+        for pos in range(offset, offset + size, entsize or SYMBOL.size):
+            name_off, value, sym_size, info, _, shndx = SYMBOL.unpack_from(data, pos)
+            kind = info & 0x0F
+            if shndx == 0 or kind not in (STT_FUNC, STT_NOTYPE):
+                continue
+            name = strings[name_off:strings.index(b"\0", name_off)].decode("ascii", "replace")
+            # Skip the ARM mapping symbols ($a, $d, $t) and local labels.
+            if not name or name.startswith("$") or name.startswith(".L"):
+                continue
+            if kind == STT_NOTYPE and sym_size != 0:
+                continue
+            start = value & ~1
+            if start not in symbols or (kind == STT_FUNC and symbols[start][1] == 0):
+                symbols[start] = (name, sym_size)
+
+    starts = sorted(symbols)
+    functions = []
+    for i, start in enumerate(starts):
+        name, size = symbols[start]
+        if size == 0:
+            # Assembly labels have no size: they run up to the next symbol.
+            size = (starts[i + 1] - start) if i + 1 < len(starts) else 4
+        functions.append((start, start + size, name))
+    return functions
+
+
+def read_bins(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    (magic, rate, samples, other, shift, itcm_bins, sys_base, sys_bins) = PROF_HEADER.unpack_from(data)
+    if magic != PROF_MAGIC:
+        sys.exit("%s: not a profiler histogram" % path)
+    counts = struct.unpack_from("<%dI" % (itcm_bins + sys_bins), data, PROF_HEADER.size)
+    bins = []
+    for i, count in enumerate(counts):
+        if count:
+            base = (i << shift) if i < itcm_bins else sys_base + ((i - itcm_bins) << shift)
+            bins.append((base, base + (1 << shift), count))
+    return rate, samples, other, shift, bins
+
+
+def attribute(functions, bins):
+    """Share the count of each bin between the functions it overlaps."""
+    starts = [start for start, _, _ in functions]
+    totals = {}
+    for lo, hi, count in bins:
+        covered = 0
+        i = max(bisect.bisect_right(starts, lo) - 1, 0)
+        while i < len(functions) and functions[i][0] < hi:
+            start, end, name = functions[i]
+            overlap = min(end, hi) - max(start, lo)
+            if overlap > 0:
+                totals[name] = totals.get(name, 0.0) + count * overlap / (hi - lo)
+                covered += overlap
+            i += 1
+        if covered < hi - lo:
+            totals["<no symbol>"] = totals.get("<no symbol>", 0.0) + count * (hi - lo - covered) / (hi - lo)
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf")
+    parser.add_argument("histogram")
+    parser.add_argument("-n", "--count", type=int, default=40, help="number of functions listed")
+    parser.add_argument("--bins", action="store_true", help="also list the busiest bins by address")
+    args = parser.parse_args()
+
+    functions = read_functions(args.elf)
+    rate, samples, other, shift, bins = read_bins(args.histogram)
+    if samples == 0:
+        sys.exit("no samples taken")
+
+    print("%u samples at %u Hz (%.1f s), %u outside the code ranges, %u bytes per bin" %
+          (samples, rate, samples / float(rate or 1), other, 1 << shift))
+    totals = attribute(functions, bins)
+    for name, count in sorted(totals.items(), key=lambda item: -item[1])[:args.count]:
+        print("  %5.1f %%  %9.1f  %s" % (100.0 * count / samples, count, name))
+
+    if args.bins:
+        print("busiest bins:")
+        for lo, _, count in sorted(bins, key=lambda b: -b[2])[:args.count]:
+            print("  0x%08x  %5.1f %%  %u" % (lo, 100.0 * count / samples, count))
+
+
+if __name__ == "__main__":
+    main()